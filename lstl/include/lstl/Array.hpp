@@ -1,10 +1,20 @@
 #pragma once
+#include <algorithm>
+#include <compare>
 #include <cstddef>
 #include <iterator>
 #include <limits>
 #include <stdexcept>
+#include <type_traits>
+#include <utility>
 namespace lstl {
-template <typename T, std::size_t N> class Array {
+namespace detail {
+// Array<T, 0> 的占位元素, 不要求T可默认构造
+struct ArrayEmpty {};
+} // namespace detail
+
+// 聚合类型, 可以用 Array<int, 3> a{1, 2, 3}; 初始化, 所有操作都可以在编译期求值
+template <typename T, std::size_t N> struct Array {
     using value_type = T;
     using size_type = std::size_t;
     using difference_type = std::ptrdiff_t;
@@ -17,93 +27,135 @@ template <typename T, std::size_t N> class Array {
     using reverse_iterator = std::reverse_iterator<iterator>;
     using const_reverse_iterator = std::reverse_iterator<const_iterator>;
 
-  private:
-    T m_data[N];
+    // 为了保持聚合类型只能是public的, 不要直接访问
+    // 零长数组不合法, N == 0 时放一个占位元素
+    std::conditional_t<N == 0, detail::ArrayEmpty, T> m_data[N == 0 ? 1 : N];
 
-  public:
-    reference at(size_t pos) {
-        if (pos < 0 || pos >= N) [[unlikely]]
+    constexpr reference at(size_type pos) {
+        if (pos >= N) [[unlikely]]
             throw std::out_of_range("out of range");
-        return m_data[pos];
+        return data()[pos];
     }
-    const_reference at(size_t pos) const {
-        if (pos < 0 || pos >= N) [[unlikely]]
+    constexpr const_reference at(size_type pos) const {
+        if (pos >= N) [[unlikely]]
             throw std::out_of_range("out of range");
-        return m_data[pos];
+        return data()[pos];
     }
 
-    reference operator[](size_type i) { return m_data[i]; }
-    const_reference operator[](size_type i) const { return m_data[i]; }
+    constexpr reference operator[](size_type i) { return data()[i]; }
+    constexpr const_reference operator[](size_type i) const {
+        return data()[i];
+    }
 
-    reference front() { return m_data[0]; }
+    constexpr reference front() { return data()[0]; }
 
-    const_reference front() const { return m_data[0]; }
+    constexpr const_reference front() const { return data()[0]; }
 
-    reference back() { return m_data[N - 1]; }
+    constexpr reference back() { return data()[N - 1]; }
 
-    const_reference back() const { return m_data[N - 1]; }
+    constexpr const_reference back() const { return data()[N - 1]; }
 
-    // 注意当*this为空时, data()不一定返回空指针
-    T* data() noexcept { return m_data; }
+    // N == 0 时返回空指针
+    constexpr T* data() noexcept {
+        if constexpr (N == 0)
+            return nullptr;
+        else
+            return m_data;
+    }
 
-    const T* data() const noexcept { return m_data; }
+    constexpr const T* data() const noexcept {
+        if constexpr (N == 0)
+            return nullptr;
+        else
+            return m_data;
+    }
 
-    iterator begin() noexcept { return m_data; }
+    constexpr iterator begin() noexcept { return data(); }
 
-    const_iterator begin() const noexcept { return m_data; }
+    constexpr const_iterator begin() const noexcept { return data(); }
 
-    const_iterator cbegin() const noexcept { return m_data; }
+    constexpr const_iterator cbegin() const noexcept { return data(); }
 
-    iterator end() noexcept { return m_data + N; }
+    constexpr iterator end() noexcept { return data() + N; }
 
-    const_iterator end() const noexcept { return m_data + N; }
+    constexpr const_iterator end() const noexcept { return data() + N; }
 
-    const_iterator cend() const noexcept { return m_data + N; }
+    constexpr const_iterator cend() const noexcept { return data() + N; }
 
-    reverse_iterator rbegin() noexcept {
-        return std::make_reverse_iterator(m_data);
+    constexpr reverse_iterator rbegin() noexcept {
+        return std::make_reverse_iterator(end());
     }
 
-    const_reverse_iterator rbegin() const noexcept {
-        return std::make_reverse_iterator(m_data);
+    constexpr const_reverse_iterator rbegin() const noexcept {
+        return std::make_reverse_iterator(end());
     }
 
-    const_reverse_iterator crbegin() const noexcept {
-        return std::make_reverse_iterator(m_data);
+    constexpr const_reverse_iterator crbegin() const noexcept {
+        return std::make_reverse_iterator(cend());
     }
 
-    reverse_iterator rend() noexcept {
-        return std::make_reverse_iterator(m_data + N);
+    constexpr reverse_iterator rend() noexcept {
+        return std::make_reverse_iterator(begin());
     }
 
-    const_reverse_iterator rend() const noexcept {
-        return std::make_reverse_iterator(m_data + N);
+    constexpr const_reverse_iterator rend() const noexcept {
+        return std::make_reverse_iterator(begin());
     }
 
-    const_reverse_iterator crend() const noexcept {
-        return std::make_reverse_iterator(m_data + N);
+    constexpr const_reverse_iterator crend() const noexcept {
+        return std::make_reverse_iterator(cbegin());
     }
 
     constexpr bool empty() const noexcept { return N == 0; }
 
-    constexpr size_t size() const noexcept { return N; }
+    constexpr size_type size() const noexcept { return N; }
 
-    static constexpr std::size_t max_size() noexcept {
-        return std::numeric_limits<std::size_t>::max() / sizeof(T);
-    }
+    static constexpr std::size_t max_size() noexcept { return N; }
 
-    void fill(const T& value) {
-        for (size_t i = 0; i < N; i++) {
-            this->m_data[i] = value;
+    constexpr void fill(const T& value) {
+        for (size_type i = 0; i < N; i++) {
+            data()[i] = value;
         }
     }
 
-    void swap(Array& that) { std::swap(m_data, that.m_data); }
+    constexpr void swap(Array& that) noexcept(std::is_nothrow_swappable_v<T>) {
+        std::swap_ranges(begin(), end(), that.begin());
+    }
+
+    constexpr bool operator==(Array const& that) const {
+        return std::equal(begin(), end(), that.begin());
+    }
+    constexpr auto operator<=>(Array const& that) const {
+        return std::lexicographical_compare_three_way(begin(), end(),
+                                                      that.begin(), that.end());
+    }
 };
 
+template <typename T, typename... U>
+Array(T, U...) -> Array<T, 1 + sizeof...(U)>;
+
+namespace detail {
+template <typename T, std::size_t N, std::size_t... I>
+constexpr Array<std::remove_cv_t<T>, N> toArrayCopy(T (&a)[N],
+                                                    std::index_sequence<I...>) {
+    return {{a[I]...}};
+}
+template <typename T, std::size_t N, std::size_t... I>
+constexpr Array<std::remove_cv_t<T>, N> toArrayMove(T (&&a)[N],
+                                                    std::index_sequence<I...>) {
+    return {{std::move(a[I])...}};
+}
+} // namespace detail
+
 template <typename T, std::size_t N>
-constexpr lstl::Array<std::remove_cv_t<T>, N> toArray(T (&)[N]) {}
+constexpr lstl::Array<std::remove_cv_t<T>, N> toArray(T (&a)[N]) {
+    static_assert(!std::is_array_v<T>, "multidimensional arrays not supported");
+    return detail::toArrayCopy(a, std::make_index_sequence<N>{});
+}
 
 template <typename T, std::size_t N>
-constexpr lstl::Array<std::remove_cv_t<T>, N> toArray(T (&&)[N]) {}
+constexpr lstl::Array<std::remove_cv_t<T>, N> toArray(T (&&a)[N]) {
+    static_assert(!std::is_array_v<T>, "multidimensional arrays not supported");
+    return detail::toArrayMove(std::move(a), std::make_index_sequence<N>{});
+}
 } // namespace lstl
@@ -0,0 +1,136 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <exception>
+#include <utility>
+
+#include "lstl/SharedPtr.hpp"
+
+namespace lstl {
+// 可以被并发读写的SharedPtr, 用于热替换配置/路由表之类的快照
+//
+// 使用split reference count:
+// 一个64位字里低48位存控制块指针, 高16位存"本地计数".
+// 读者先对本地计数fetch_add占位, 再对控制块incref, 最后归还本地计数;
+// 写者exchange时把被换出字里的本地计数一次性转移到控制块的全局计数上,
+// 没来得及归还的读者发现指针已变, 改为decref一次.
+// 读写都不加锁, 写者是wait-free的, 读者不会阻塞写者.
+template <typename T> class AtomicSharedPtr {
+    static_assert(sizeof(void*) == 8, "AtomicSharedPtr needs 64-bit pointers");
+
+    using Block = SpControlBlock<T>;
+    static constexpr unsigned kPtrBits = 48;
+    static constexpr std::uint64_t kPtrMask = (std::uint64_t(1) << kPtrBits) - 1;
+    static constexpr std::uint64_t kOneLocal = std::uint64_t(1) << kPtrBits;
+
+  public:
+    using value_type = SharedPtr<T>;
+
+    static constexpr bool is_always_lock_free =
+        std::atomic<std::uint64_t>::is_always_lock_free;
+
+    AtomicSharedPtr() noexcept : m_word(0) {}
+    AtomicSharedPtr(std::nullptr_t) noexcept : m_word(0) {}
+    AtomicSharedPtr(SharedPtr<T> desired) noexcept
+        : m_word(toWord(std::exchange(desired.m_pcb, nullptr))) {}
+
+    AtomicSharedPtr(AtomicSharedPtr const&) = delete;
+    AtomicSharedPtr& operator=(AtomicSharedPtr const&) = delete;
+
+    ~AtomicSharedPtr() {
+        // 析构时不应该还有并发的读者, 本地计数必为0
+        if (Block* pcb = toBlock(m_word.load(std::memory_order_acquire)))
+            pcb->decref();
+    }
+
+    AtomicSharedPtr& operator=(SharedPtr<T> desired) noexcept {
+        store(std::move(desired));
+        return *this;
+    }
+
+    operator SharedPtr<T>() const noexcept { return load(); }
+
+    bool is_lock_free() const noexcept { return m_word.is_lock_free(); }
+
+    SharedPtr<T> load() const noexcept {
+        std::uint64_t old = m_word.fetch_add(kOneLocal, std::memory_order_acquire);
+        Block* pcb = toBlock(old);
+        if (pcb)
+            pcb->incref();
+        releaseLocal(pcb);
+        return SharedPtr<T>(pcb, typename SharedPtr<T>::AdoptTag{});
+    }
+
+    void store(SharedPtr<T> desired) noexcept { exchange(std::move(desired)); }
+
+    SharedPtr<T> exchange(SharedPtr<T> desired) noexcept {
+        Block* next = std::exchange(desired.m_pcb, nullptr);
+        std::uint64_t old =
+            m_word.exchange(toWord(next), std::memory_order_acq_rel);
+        Block* prev = toBlock(old);
+        transferLocal(prev, old);
+        // 原本由本对象持有的那一份引用交给返回值
+        return SharedPtr<T>(prev, typename SharedPtr<T>::AdoptTag{});
+    }
+
+    // 当前值与expected指向同一控制块时替换为desired并返回true;
+    // 否则把当前值读到expected中并返回false
+    bool compare_exchange(SharedPtr<T>& expected,
+                          SharedPtr<T> desired) noexcept {
+        std::uint64_t cur = m_word.load(std::memory_order_relaxed);
+        while (toBlock(cur) == expected.m_pcb) {
+            // 本地计数变化也会导致失败, 此时重试即可
+            if (m_word.compare_exchange_weak(cur, toWord(desired.m_pcb),
+                                             std::memory_order_acq_rel,
+                                             std::memory_order_relaxed)) {
+                desired.m_pcb = nullptr;
+                Block* prev = toBlock(cur);
+                transferLocal(prev, cur);
+                if (prev)
+                    prev->decref();
+                return true;
+            }
+        }
+        expected = load();
+        return false;
+    }
+
+  private:
+    static std::uint64_t toWord(Block* pcb) noexcept {
+        auto bits = reinterpret_cast<std::uintptr_t>(pcb);
+        // 5级页表(LA57)或带标签的指针(TBI/MTE)会用到高16位, 存进来会被截断成
+        // 本地计数. 发布版本里也要检查, 接口都是noexcept的, 只能终止
+        if ((bits & ~kPtrMask) != 0) [[unlikely]]
+            std::terminate();
+        return bits;
+    }
+    static Block* toBlock(std::uint64_t word) noexcept {
+        return reinterpret_cast<Block*>(
+            static_cast<std::uintptr_t>(word & kPtrMask));
+    }
+    static long localCount(std::uint64_t word) noexcept {
+        return static_cast<long>(word >> kPtrBits);
+    }
+
+    // 换出的字上还挂着读者的本地计数, 替这些读者在控制块上记账
+    static void transferLocal(Block* prev, std::uint64_t word) noexcept {
+        if (prev && localCount(word) != 0)
+            prev->incref(localCount(word));
+    }
+
+    // 读者归还本地计数. 计数是可互换的, 只要指针没变且计数非0就可以减;
+    // 否则说明写者已经替我们incref过了, 改为decref
+    void releaseLocal(Block* pcb) const noexcept {
+        std::uint64_t cur = m_word.load(std::memory_order_relaxed);
+        while (toBlock(cur) == pcb && localCount(cur) != 0) {
+            if (m_word.compare_exchange_weak(cur, cur - kOneLocal,
+                                             std::memory_order_relaxed))
+                return;
+        }
+        if (pcb)
+            pcb->decref();
+    }
+
+    mutable std::atomic<std::uint64_t> m_word;
+};
+} // namespace lstl
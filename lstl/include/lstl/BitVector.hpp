@@ -0,0 +1,311 @@
+#pragma once
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+
+#include "lstl/Vector.hpp"
+
+namespace lstl {
+// 按位存放的bool数组, 每64位一个字
+// 最后一个字里超出size的位始终为0, 所以popcount/比较可以直接按字做.
+// 批量的与/或/异或/andnot 和 popcount 都是按字的简单循环, 不带分支,
+// 交给编译器自动向量化.
+class BitVector {
+  public:
+    using word_type = std::uint64_t;
+    using size_type = std::size_t;
+    static constexpr size_type kWordBits = 64;
+    static constexpr size_type npos = static_cast<size_type>(-1);
+
+    // operator[] 返回的代理引用
+    class reference {
+      public:
+        reference(word_type* word, word_type mask) noexcept
+            : m_word(word), m_mask(mask) {}
+
+        operator bool() const noexcept { return *m_word & m_mask; }
+        reference& operator=(bool value) noexcept {
+            if (value)
+                *m_word |= m_mask;
+            else
+                *m_word &= ~m_mask;
+            return *this;
+        }
+        reference& operator=(reference const& that) noexcept {
+            return *this = static_cast<bool>(that);
+        }
+        void flip() noexcept { *m_word ^= m_mask; }
+
+      private:
+        word_type* m_word;
+        word_type m_mask;
+    };
+
+    BitVector() noexcept = default;
+
+    explicit BitVector(size_type n, bool value = false) { resize(n, value); }
+
+    // about size
+
+    bool empty() const noexcept { return m_size == 0; }
+    size_type size() const noexcept { return m_size; }
+    size_type capacity() const noexcept {
+        return m_words.capacity() * kWordBits;
+    }
+
+    void reserve(size_type n) { m_words.reserve(wordsFor(n)); }
+
+    void resize(size_type n, bool value = false) {
+        size_type old = m_size;
+        m_words.resize(wordsFor(n), value ? ~word_type(0) : word_type(0));
+        if (value && n > old && old % kWordBits)
+            m_words[old / kWordBits] |= ~word_type(0) << (old % kWordBits);
+        m_size = n;
+        clearTail();
+    }
+
+    void clear() noexcept {
+        m_words.clear();
+        m_size = 0;
+    }
+
+    // element access
+
+    bool operator[](size_type i) const noexcept { return test(i); }
+    reference operator[](size_type i) noexcept {
+        return reference(&m_words[i / kWordBits], maskOf(i));
+    }
+
+    bool test(size_type i) const noexcept {
+        return m_words[i / kWordBits] & maskOf(i);
+    }
+
+    bool at(size_type i) const {
+        if (i >= m_size) [[unlikely]]
+            throw std::out_of_range("bit_vector::at out_of_range");
+        return test(i);
+    }
+
+    // 底层的字, 最后一个字的高位是0
+    std::span<word_type const> words() const noexcept {
+        return {m_words.data(), m_words.size()};
+    }
+
+    // modifier
+
+    void push_back(bool value) {
+        if (m_size % kWordBits == 0)
+            m_words.push_back(0);
+        if (value)
+            m_words.back() |= maskOf(m_size);
+        m_size++;
+    }
+
+    void pop_back() noexcept {
+        m_size--;
+        m_words[m_size / kWordBits] &= ~maskOf(m_size);
+        if (m_size % kWordBits == 0)
+            m_words.pop_back();
+    }
+
+    void set(size_type i, bool value = true) noexcept { (*this)[i] = value; }
+    void reset(size_type i) noexcept { m_words[i / kWordBits] &= ~maskOf(i); }
+    void flip(size_type i) noexcept { m_words[i / kWordBits] ^= maskOf(i); }
+
+    void set() noexcept {
+        std::fill(m_words.begin(), m_words.end(), ~word_type(0));
+        clearTail();
+    }
+    void reset() noexcept {
+        std::fill(m_words.begin(), m_words.end(), word_type(0));
+    }
+    void flip() noexcept {
+        word_type* w = m_words.data();
+        for (size_type i = 0, n = m_words.size(); i != n; i++)
+            w[i] = ~w[i];
+        clearTail();
+    }
+
+    // 批量操作, 两边的size必须相同
+
+    BitVector& operator&=(BitVector const& that) {
+        checkSize(that);
+        apply(that, [](word_type a, word_type b) { return a & b; });
+        return *this;
+    }
+    BitVector& operator|=(BitVector const& that) {
+        checkSize(that);
+        apply(that, [](word_type a, word_type b) { return a | b; });
+        return *this;
+    }
+    BitVector& operator^=(BitVector const& that) {
+        checkSize(that);
+        apply(that, [](word_type a, word_type b) { return a ^ b; });
+        return *this;
+    }
+    // *this &= ~that
+    BitVector& andnot(BitVector const& that) {
+        checkSize(that);
+        apply(that, [](word_type a, word_type b) { return a & ~b; });
+        return *this;
+    }
+
+    friend BitVector operator&(BitVector a, BitVector const& b) {
+        return a &= b;
+    }
+    friend BitVector operator|(BitVector a, BitVector const& b) {
+        return a |= b;
+    }
+    friend BitVector operator^(BitVector a, BitVector const& b) {
+        return a ^= b;
+    }
+
+    // 查询
+
+    // 置位的个数
+    size_type popcount() const noexcept {
+        word_type const* w = m_words.data();
+        size_type sum = 0;
+        for (size_type i = 0, n = m_words.size(); i != n; i++)
+            sum += static_cast<size_type>(std::popcount(w[i]));
+        return sum;
+    }
+
+    bool any() const noexcept {
+        return std::any_of(m_words.begin(), m_words.end(),
+                           [](word_type w) { return w != 0; });
+    }
+    bool none() const noexcept { return !any(); }
+    bool all() const noexcept { return popcount() == m_size; }
+
+    // 第一个置位的下标, 没有时返回npos
+    size_type find_first() const noexcept { return findFrom(0); }
+    // i 之后(不含i)第一个置位的下标; i >= size() (包括npos)时返回npos
+    size_type find_next(size_type i) const noexcept {
+        return i >= m_size ? npos : findFrom(i + 1);
+    }
+
+    friend bool operator==(BitVector const& a, BitVector const& b) noexcept {
+        return a.m_size == b.m_size &&
+               std::equal(a.m_words.begin(), a.m_words.end(),
+                          b.m_words.begin());
+    }
+
+  private:
+    static size_type wordsFor(size_type n) noexcept {
+        return (n + kWordBits - 1) / kWordBits;
+    }
+    static word_type maskOf(size_type i) noexcept {
+        return word_type(1) << (i % kWordBits);
+    }
+
+    void clearTail() noexcept {
+        if (m_size % kWordBits)
+            m_words.back() &= (word_type(1) << (m_size % kWordBits)) - 1;
+    }
+
+    void checkSize(BitVector const& that) const {
+        if (m_size != that.m_size)
+            throw std::invalid_argument("bit_vector size mismatch");
+    }
+
+    template <typename Op> void apply(BitVector const& that, Op op) noexcept {
+        word_type* a = m_words.data();
+        word_type const* b = that.m_words.data();
+        for (size_type i = 0, n = m_words.size(); i != n; i++)
+            a[i] = op(a[i], b[i]);
+    }
+
+    size_type findFrom(size_type pos) const noexcept {
+        if (pos >= m_size)
+            return npos;
+        size_type w = pos / kWordBits;
+        word_type bits = m_words[w] & (~word_type(0) << (pos % kWordBits));
+        while (!bits) {
+            if (++w == m_words.size())
+                return npos;
+            bits = m_words[w];
+        }
+        return w * kWordBits + static_cast<size_type>(std::countr_zero(bits));
+    }
+
+    Vector<word_type> m_words;
+    size_type m_size = 0;
+};
+
+// BitVector 上的rank/select索引
+// 每512位(8个字)记一个前缀和, rank 最多再数8个字, 是O(1)的;
+// select 在前缀和上二分, 再在块内逐字查找.
+// 建好之后bits不能再修改, 修改后需要重新build.
+class RankSelect {
+  public:
+    using size_type = BitVector::size_type;
+    static constexpr size_type npos = BitVector::npos;
+
+    // 空的索引, rank 总是0, select 总是npos
+    RankSelect() { m_blocks.push_back(0); }
+    explicit RankSelect(BitVector const& bits) { build(bits); }
+
+    void build(BitVector const& bits) {
+        m_words = bits.words();
+        m_blocks.clear();
+        m_blocks.reserve(m_words.size() / kBlockWords + 2);
+        size_type sum = 0;
+        for (size_type w = 0; w != m_words.size(); w++) {
+            if (w % kBlockWords == 0)
+                m_blocks.push_back(sum);
+            sum += static_cast<size_type>(std::popcount(m_words[w]));
+        }
+        m_blocks.push_back(sum);
+    }
+
+    // [0, i) 中置位的个数, i <= size()
+    size_type rank(size_type i) const noexcept {
+        size_type w = i / BitVector::kWordBits;
+        size_type b = w / kBlockWords;
+        size_type r = m_blocks[b];
+        for (size_type j = b * kBlockWords; j != w; j++)
+            r += static_cast<size_type>(std::popcount(m_words[j]));
+        if (i % BitVector::kWordBits)
+            r += static_cast<size_type>(std::popcount(
+                m_words[w] &
+                ((BitVector::word_type(1) << (i % BitVector::kWordBits)) - 1)));
+        return r;
+    }
+
+    // 第k个(从0开始)置位的下标, 不存在时返回npos
+    size_type select(size_type k) const noexcept {
+        if (k >= count())
+            return npos;
+        // 最后一个前缀和 <= k 的块
+        auto it = std::upper_bound(m_blocks.begin(), m_blocks.end(), k);
+        auto b = static_cast<size_type>(it - m_blocks.begin()) - 1;
+        k -= m_blocks[b];
+        size_type w = b * kBlockWords;
+        for (;; w++) {
+            auto c = static_cast<size_type>(std::popcount(m_words[w]));
+            if (k < c)
+                break;
+            k -= c;
+        }
+        BitVector::word_type bits = m_words[w];
+        for (; k; k--)
+            bits &= bits - 1;
+        return w * BitVector::kWordBits +
+               static_cast<size_type>(std::countr_zero(bits));
+    }
+
+    size_type count() const noexcept {
+        return m_blocks.empty() ? 0 : m_blocks.back();
+    }
+
+  private:
+    static constexpr size_type kBlockWords = 8;
+
+    std::span<BitVector::word_type const> m_words;
+    Vector<size_type> m_blocks; // 每块之前的置位数, 最后一项是总数
+};
+} // namespace lstl
@@ -0,0 +1,198 @@
+#pragma once
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "lstl/Vector.hpp"
+
+namespace lstl {
+// 分段的可并发追加的vector
+// 段k的大小是2的幂: 段0有kFirst个元素, 之后每段是前面所有段之和,
+// 段一旦分配就不再移动, 所以元素地址和引用在并发增长时保持有效.
+// push_back/grow_by 用 fetch_add 抢下标, 只有第一次用到某个段时才分配.
+//
+// 并发追加是安全的; 读某个元素前需要与写它的线程同步(比如join),
+// size() 返回的是已经抢走的下标数, 不保证这些元素都已构造完.
+// 每个段带一个标记数组, 构造成功后才置位: 分配或构造抛异常时下标已经被抢走,
+// 这个位置不能访问, clear/析构只销毁置位的元素, freeze会跳过它.
+// clear/freeze/析构 不能与追加并发.
+template <typename T, typename Alloc = std::allocator<T>>
+class ConcurrentVector {
+    static constexpr std::size_t kFirstBits = 3;
+    static constexpr std::size_t kFirst = std::size_t(1) << kFirstBits;
+    static constexpr std::size_t kMaxSegments =
+        sizeof(std::size_t) * 8 - kFirstBits + 1;
+    using BuiltAlloc =
+        typename std::allocator_traits<Alloc>::template rebind_alloc<bool>;
+
+  public:
+    using value_type = T;
+    using allocator_type = Alloc;
+    using size_type = std::size_t;
+    using reference = T&;
+    using const_reference = T const&;
+
+    ConcurrentVector() noexcept(noexcept(Alloc())) : ConcurrentVector(Alloc()) {}
+    explicit ConcurrentVector(Alloc const& alloc) noexcept : m_alloc(alloc) {
+        for (auto& seg : m_segments)
+            seg.store(nullptr, std::memory_order_relaxed);
+        for (auto& built : m_built)
+            built.store(nullptr, std::memory_order_relaxed);
+    }
+
+    ConcurrentVector(ConcurrentVector const&) = delete;
+    ConcurrentVector& operator=(ConcurrentVector const&) = delete;
+
+    ~ConcurrentVector() {
+        clear();
+        for (size_type k = 0; k != kMaxSegments; k++) {
+            if (T* seg = m_segments[k].load(std::memory_order_relaxed))
+                m_alloc.deallocate(seg, segmentSize(k));
+            if (bool* built = m_built[k].load(std::memory_order_relaxed))
+                BuiltAlloc(m_alloc).deallocate(built, segmentSize(k));
+        }
+    }
+
+    reference push_back(T const& value) { return emplace_back(value); }
+    reference push_back(T&& value) { return emplace_back(std::move(value)); }
+
+    template <typename... Args> reference emplace_back(Args&&... args) {
+        size_type i = m_size.fetch_add(1, std::memory_order_relaxed);
+        return construct(i, std::forward<Args>(args)...);
+    }
+
+    // 一次抢n个连续下标, 返回第一个元素的下标
+    // 中途抛异常时, 后面的下标都保持未构造
+    size_type grow_by(size_type n, T const& value = T()) {
+        size_type first = m_size.fetch_add(n, std::memory_order_relaxed);
+        for (size_type i = first; i != first + n; i++)
+            construct(i, value);
+        return first;
+    }
+
+    template <typename InputIterator>
+    size_type grow_by(InputIterator first, InputIterator last) {
+        auto n = static_cast<size_type>(std::distance(first, last));
+        size_type start = m_size.fetch_add(n, std::memory_order_relaxed);
+        for (size_type i = start; i != start + n; ++i, ++first)
+            construct(i, *first);
+        return start;
+    }
+
+    reference operator[](size_type i) noexcept { return *address(i); }
+    const_reference operator[](size_type i) const noexcept {
+        return *address(i);
+    }
+
+    reference at(size_type i) {
+        if (i >= size()) [[unlikely]]
+            throw std::out_of_range("concurrent_vector::at out_of_range");
+        return *address(i);
+    }
+    const_reference at(size_type i) const {
+        if (i >= size()) [[unlikely]]
+            throw std::out_of_range("concurrent_vector::at out_of_range");
+        return *address(i);
+    }
+
+    size_type size() const noexcept {
+        return m_size.load(std::memory_order_acquire);
+    }
+    bool empty() const noexcept { return size() == 0; }
+
+    // 保留已分配的段
+    void clear() noexcept {
+        size_type n = m_size.load(std::memory_order_relaxed);
+        for (size_type k = 0; k != kMaxSegments && segmentBase(k) < n; k++) {
+            bool* built = m_built[k].load(std::memory_order_relaxed);
+            if (!built)
+                continue;
+            T* seg = m_segments[k].load(std::memory_order_relaxed);
+            size_type count = std::min(segmentSize(k), n - segmentBase(k));
+            for (size_type j = 0; j != count; j++) {
+                if (built[j]) {
+                    std::destroy_at(seg + j);
+                    built[j] = false;
+                }
+            }
+        }
+        m_size.store(0, std::memory_order_relaxed);
+    }
+
+    // 追加结束后导出成连续的Vector, 元素被移走, *this变为空
+    Vector<T> freeze() {
+        Vector<T> out;
+        size_type n = size();
+        out.reserve(n);
+        for (size_type k = 0; k != kMaxSegments && segmentBase(k) < n; k++) {
+            bool* built = m_built[k].load(std::memory_order_relaxed);
+            if (!built)
+                continue;
+            T* seg = m_segments[k].load(std::memory_order_relaxed);
+            size_type count = std::min(segmentSize(k), n - segmentBase(k));
+            for (size_type j = 0; j != count; j++) {
+                if (built[j])
+                    out.push_back(std::move(seg[j]));
+            }
+        }
+        clear();
+        return out;
+    }
+
+  private:
+    static size_type segmentOf(size_type i) noexcept {
+        return static_cast<size_type>(std::bit_width(i | (kFirst - 1))) -
+               kFirstBits;
+    }
+    static size_type segmentBase(size_type k) noexcept {
+        return k == 0 ? 0 : kFirst << (k - 1);
+    }
+    static size_type segmentSize(size_type k) noexcept {
+        return k == 0 ? kFirst : kFirst << (k - 1);
+    }
+
+    T* address(size_type i) const noexcept {
+        size_type k = segmentOf(i);
+        return m_segments[k].load(std::memory_order_acquire) +
+               (i - segmentBase(k));
+    }
+
+    // 构造成功后才置位标记, 抛异常时这个下标保持未构造
+    template <typename... Args> T& construct(size_type i, Args&&... args) {
+        size_type k = segmentOf(i);
+        size_type j = i - segmentBase(k);
+        bool* built = segment(m_built[k], BuiltAlloc(m_alloc), k);
+        T* seg = segment(m_segments[k], m_alloc, k);
+        T* p = std::construct_at(seg + j, std::forward<Args>(args)...);
+        built[j] = true;
+        return *p;
+    }
+
+    // 需要时分配段, 多个线程同时分配时只有一个CAS成功, 其余的释放掉自己的
+    template <typename U, typename A>
+    static U* segment(std::atomic<U*>& slot, A&& alloc, size_type k) {
+        U* seg = slot.load(std::memory_order_acquire);
+        if (!seg) [[unlikely]] {
+            U* fresh = alloc.allocate(segmentSize(k));
+            if constexpr (std::is_same_v<U, bool>)
+                std::uninitialized_fill_n(fresh, segmentSize(k), false);
+            if (slot.compare_exchange_strong(seg, fresh,
+                                             std::memory_order_acq_rel,
+                                             std::memory_order_acquire))
+                seg = fresh;
+            else
+                alloc.deallocate(fresh, segmentSize(k));
+        }
+        return seg;
+    }
+
+    std::atomic<T*> m_segments[kMaxSegments];
+    std::atomic<bool*> m_built[kMaxSegments];
+    alignas(64) std::atomic<size_type> m_size{0};
+    [[no_unique_address]] Alloc m_alloc;
+};
+} // namespace lstl
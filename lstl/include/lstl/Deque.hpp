@@ -0,0 +1,324 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace lstl {
+// 分块的双端队列
+// 元素存放在固定大小的块里, 块指针放在一张map上.
+// 两端push/pop都是O(1), 随机访问是 map -> 块 两跳;
+// 扩容时只搬块指针, 从不整体拷贝元素, 所以没有Vector那种倍增时的延迟尖峰
+// 和三倍内存峰值. 在两端增删时, 其余元素的地址和引用保持不变.
+template <typename T, typename Alloc = std::allocator<T>> class Deque {
+    // 每块约4KB, 元素很大时至少16个
+    static constexpr std::size_t kBlock =
+        sizeof(T) < 256 ? 4096 / sizeof(T) : 16;
+
+    using AllocTraits = std::allocator_traits<Alloc>;
+    using MapAlloc = typename AllocTraits::template rebind_alloc<T*>;
+
+    template <bool Const> class Iterator {
+        using Owner = std::conditional_t<Const, Deque const, Deque>;
+
+      public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = std::conditional_t<Const, T const*, T*>;
+        using reference = std::conditional_t<Const, T const&, T&>;
+
+        Iterator() noexcept = default;
+        Iterator(Owner* owner, std::size_t i) noexcept
+            : m_owner(owner), m_i(i) {}
+        operator Iterator<true>() const noexcept { return {m_owner, m_i}; }
+
+        reference operator*() const noexcept { return (*m_owner)[m_i]; }
+        pointer operator->() const noexcept { return &(*m_owner)[m_i]; }
+        reference operator[](difference_type n) const noexcept {
+            return (*m_owner)[m_i + static_cast<std::size_t>(n)];
+        }
+
+        Iterator& operator++() noexcept {
+            ++m_i;
+            return *this;
+        }
+        Iterator operator++(int) noexcept { return {m_owner, m_i++}; }
+        Iterator& operator--() noexcept {
+            --m_i;
+            return *this;
+        }
+        Iterator operator--(int) noexcept { return {m_owner, m_i--}; }
+        Iterator& operator+=(difference_type n) noexcept {
+            m_i += static_cast<std::size_t>(n);
+            return *this;
+        }
+        Iterator& operator-=(difference_type n) noexcept {
+            m_i -= static_cast<std::size_t>(n);
+            return *this;
+        }
+        friend Iterator operator+(Iterator it, difference_type n) noexcept {
+            return it += n;
+        }
+        friend Iterator operator+(difference_type n, Iterator it) noexcept {
+            return it += n;
+        }
+        friend Iterator operator-(Iterator it, difference_type n) noexcept {
+            return it -= n;
+        }
+        friend difference_type operator-(Iterator a, Iterator b) noexcept {
+            return static_cast<difference_type>(a.m_i) -
+                   static_cast<difference_type>(b.m_i);
+        }
+        bool operator==(Iterator const& that) const noexcept {
+            return m_i == that.m_i;
+        }
+        auto operator<=>(Iterator const& that) const noexcept {
+            return m_i <=> that.m_i;
+        }
+
+      private:
+        Owner* m_owner = nullptr;
+        std::size_t m_i = 0;
+    };
+
+  public:
+    using value_type = T;
+    using allocator_type = Alloc;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using reference = T&;
+    using const_reference = T const&;
+    using iterator = Iterator<false>;
+    using const_iterator = Iterator<true>;
+    using reverse_iterator = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+    Deque() noexcept(noexcept(Alloc())) : Deque(Alloc()) {}
+    explicit Deque(Alloc const& alloc) noexcept : m_alloc(alloc) {}
+
+    Deque(std::initializer_list<T> lst, Alloc const& alloc = Alloc())
+        : m_alloc(alloc) {
+        for (auto const& value : lst)
+            push_back(value);
+    }
+
+    Deque(Deque const& that)
+        : m_alloc(AllocTraits::select_on_container_copy_construction(
+              that.m_alloc)) {
+        for (auto const& value : that)
+            push_back(value);
+    }
+
+    Deque(Deque&& that) noexcept
+        : m_map(std::exchange(that.m_map, nullptr)),
+          m_mapSize(std::exchange(that.m_mapSize, 0)),
+          m_firstBlock(std::exchange(that.m_firstBlock, 0)),
+          m_blocks(std::exchange(that.m_blocks, 0)),
+          m_start(std::exchange(that.m_start, 0)),
+          m_size(std::exchange(that.m_size, 0)),
+          m_alloc(std::move(that.m_alloc)) {}
+
+    Deque& operator=(Deque that) noexcept {
+        swap(that);
+        return *this;
+    }
+
+    ~Deque() {
+        clear();
+        for (size_type b = 0; b != m_blocks; b++)
+            AllocTraits::deallocate(m_alloc, m_map[m_firstBlock + b], kBlock);
+        if (m_map) {
+            MapAlloc mapAlloc(m_alloc);
+            std::allocator_traits<MapAlloc>::deallocate(mapAlloc, m_map,
+                                                        m_mapSize);
+        }
+    }
+
+    void swap(Deque& that) noexcept {
+        std::swap(m_map, that.m_map);
+        std::swap(m_mapSize, that.m_mapSize);
+        std::swap(m_firstBlock, that.m_firstBlock);
+        std::swap(m_blocks, that.m_blocks);
+        std::swap(m_start, that.m_start);
+        std::swap(m_size, that.m_size);
+        std::swap(m_alloc, that.m_alloc);
+    }
+
+    // element access
+
+    reference operator[](size_type i) noexcept {
+        size_type pos = m_start + i;
+        return m_map[m_firstBlock + pos / kBlock][pos % kBlock];
+    }
+    const_reference operator[](size_type i) const noexcept {
+        size_type pos = m_start + i;
+        return m_map[m_firstBlock + pos / kBlock][pos % kBlock];
+    }
+
+    reference at(size_type i) {
+        if (i >= m_size) [[unlikely]]
+            throw std::out_of_range("deque::at out_of_range");
+        return (*this)[i];
+    }
+    const_reference at(size_type i) const {
+        if (i >= m_size) [[unlikely]]
+            throw std::out_of_range("deque::at out_of_range");
+        return (*this)[i];
+    }
+
+    reference front() noexcept { return (*this)[0]; }
+    const_reference front() const noexcept { return (*this)[0]; }
+    reference back() noexcept { return (*this)[m_size - 1]; }
+    const_reference back() const noexcept { return (*this)[m_size - 1]; }
+
+    // iterators
+
+    iterator begin() noexcept { return {this, 0}; }
+    const_iterator begin() const noexcept { return {this, 0}; }
+    const_iterator cbegin() const noexcept { return {this, 0}; }
+    iterator end() noexcept { return {this, m_size}; }
+    const_iterator end() const noexcept { return {this, m_size}; }
+    const_iterator cend() const noexcept { return {this, m_size}; }
+    reverse_iterator rbegin() noexcept { return reverse_iterator(end()); }
+    const_reverse_iterator rbegin() const noexcept {
+        return const_reverse_iterator(end());
+    }
+    reverse_iterator rend() noexcept { return reverse_iterator(begin()); }
+    const_reverse_iterator rend() const noexcept {
+        return const_reverse_iterator(begin());
+    }
+
+    // about size
+
+    bool empty() const noexcept { return m_size == 0; }
+    size_type size() const noexcept { return m_size; }
+
+    // modifier
+
+    void push_back(T const& value) { emplace_back(value); }
+    void push_back(T&& value) { emplace_back(std::move(value)); }
+
+    template <typename... Args> reference emplace_back(Args&&... args) {
+        if (m_start + m_size == m_blocks * kBlock) [[unlikely]]
+            addBlockBack();
+        size_type pos = m_start + m_size;
+        T* p = &m_map[m_firstBlock + pos / kBlock][pos % kBlock];
+        AllocTraits::construct(m_alloc, p, std::forward<Args>(args)...);
+        m_size++;
+        return *p;
+    }
+
+    void push_front(T const& value) { emplace_front(value); }
+    void push_front(T&& value) { emplace_front(std::move(value)); }
+
+    template <typename... Args> reference emplace_front(Args&&... args) {
+        if (m_start == 0) [[unlikely]]
+            addBlockFront();
+        T* p = &m_map[m_firstBlock + (m_start - 1) / kBlock]
+                     [(m_start - 1) % kBlock];
+        AllocTraits::construct(m_alloc, p, std::forward<Args>(args)...);
+        m_start--;
+        m_size++;
+        return *p;
+    }
+
+    void pop_back() noexcept {
+        AllocTraits::destroy(m_alloc, &back());
+        m_size--;
+        // 尾部留一个空块作缓冲, 避免在块边界上反复分配释放
+        if (m_blocks * kBlock - (m_start + m_size) >= 2 * kBlock) {
+            m_blocks--;
+            AllocTraits::deallocate(m_alloc, m_map[m_firstBlock + m_blocks],
+                                    kBlock);
+        }
+    }
+
+    void pop_front() noexcept {
+        AllocTraits::destroy(m_alloc, &front());
+        m_start++;
+        m_size--;
+        if (m_start >= 2 * kBlock) {
+            AllocTraits::deallocate(m_alloc, m_map[m_firstBlock], kBlock);
+            m_firstBlock++;
+            m_blocks--;
+            m_start -= kBlock;
+        }
+    }
+
+    // 保留块, 不释放内存
+    void clear() noexcept {
+        for (size_type i = 0; i != m_size; i++)
+            AllocTraits::destroy(m_alloc, &(*this)[i]);
+        m_size = 0;
+        m_start = 0;
+    }
+
+    // 释放两端没有元素的块
+    void shrink_to_fit() noexcept {
+        while (m_blocks && m_start >= kBlock) {
+            AllocTraits::deallocate(m_alloc, m_map[m_firstBlock], kBlock);
+            m_firstBlock++;
+            m_blocks--;
+            m_start -= kBlock;
+        }
+        while (m_blocks && m_blocks * kBlock - (m_start + m_size) >= kBlock) {
+            m_blocks--;
+            AllocTraits::deallocate(m_alloc, m_map[m_firstBlock + m_blocks],
+                                    kBlock);
+        }
+    }
+
+  private:
+    // map一端没有空位时换一张map, 只搬块指针, 已用部分放在中间.
+    // 已用部分不到一半时(比如一直push_back/pop_front)不扩大, 只重新居中
+    void growMap() {
+        size_type newSize = m_blocks * 2 < m_mapSize
+                                ? m_mapSize
+                                : std::max<size_type>(8, m_mapSize * 2);
+        MapAlloc mapAlloc(m_alloc);
+        T** fresh =
+            std::allocator_traits<MapAlloc>::allocate(mapAlloc, newSize);
+        size_type first = (newSize - m_blocks) / 2;
+        std::copy_n(m_map + m_firstBlock, m_blocks, fresh + first);
+        if (m_map)
+            std::allocator_traits<MapAlloc>::deallocate(mapAlloc, m_map,
+                                                        m_mapSize);
+        m_map = fresh;
+        m_mapSize = newSize;
+        m_firstBlock = first;
+    }
+
+    void addBlockBack() {
+        if (m_firstBlock + m_blocks == m_mapSize)
+            growMap();
+        m_map[m_firstBlock + m_blocks] = AllocTraits::allocate(m_alloc, kBlock);
+        m_blocks++;
+    }
+
+    void addBlockFront() {
+        if (m_firstBlock == 0)
+            growMap();
+        m_map[m_firstBlock - 1] = AllocTraits::allocate(m_alloc, kBlock);
+        m_firstBlock--;
+        m_blocks++;
+        m_start += kBlock;
+    }
+
+    T** m_map = nullptr;
+    size_type m_mapSize = 0;
+    size_type m_firstBlock = 0; // 第一个已分配块在map中的下标
+    size_type m_blocks = 0;     // 已分配的块数, 在map中连续
+    size_type m_start = 0;      // 第一个元素在第一个块中的偏移
+    size_type m_size = 0;
+    [[no_unique_address]] Alloc m_alloc;
+};
+
+// 只在两端增删时元素地址不变, 可以当作引用稳定的vector使用
+template <typename T, typename Alloc = std::allocator<T>>
+using StableVector = Deque<T, Alloc>;
+} // namespace lstl
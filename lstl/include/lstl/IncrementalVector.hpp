@@ -0,0 +1,164 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+
+namespace lstl {
+// 扩容时不一次性搬完所有元素的vector
+// 容量用满时分配两倍大小的新缓冲区, 旧元素留在旧缓冲区里,
+// 之后每次push_back顺带搬kStep个, 在新缓冲区被填满之前一定搬完.
+// 单次push_back的最坏开销从O(n)降到O(1), 代价是搬家期间operator[]多一次分支,
+// 并且新旧两块内存会同时存在一段时间.
+// 搬家期间元素不连续, data() 会先把剩下的搬完.
+template <typename T, typename Alloc = std::allocator<T>>
+class IncrementalVector {
+    static constexpr std::size_t kStep = 2;
+    using AllocTraits = std::allocator_traits<Alloc>;
+
+  public:
+    using value_type = T;
+    using allocator_type = Alloc;
+    using size_type = std::size_t;
+    using reference = T&;
+    using const_reference = T const&;
+
+    IncrementalVector() noexcept(noexcept(Alloc()))
+        : IncrementalVector(Alloc()) {}
+    explicit IncrementalVector(Alloc const& alloc) noexcept : m_alloc(alloc) {}
+
+    IncrementalVector(IncrementalVector const&) = delete;
+    IncrementalVector& operator=(IncrementalVector const&) = delete;
+
+    ~IncrementalVector() {
+        clear();
+        if (m_data)
+            AllocTraits::deallocate(m_alloc, m_data, m_capacity);
+    }
+
+    // element access
+
+    reference operator[](size_type i) noexcept {
+        return i >= m_moved && i < m_oldSize ? m_old[i] : m_data[i];
+    }
+    const_reference operator[](size_type i) const noexcept {
+        return i >= m_moved && i < m_oldSize ? m_old[i] : m_data[i];
+    }
+
+    reference at(size_type i) {
+        if (i >= m_size) [[unlikely]]
+            throw std::out_of_range("incremental_vector::at out_of_range");
+        return (*this)[i];
+    }
+
+    reference front() noexcept { return (*this)[0]; }
+    reference back() noexcept { return (*this)[m_size - 1]; }
+
+    T* data() {
+        finishMigration();
+        return m_data;
+    }
+
+    // about size
+
+    bool empty() const noexcept { return m_size == 0; }
+    size_type size() const noexcept { return m_size; }
+    size_type capacity() const noexcept { return m_capacity; }
+    bool migrating() const noexcept { return m_old != nullptr; }
+
+    // 显式reserve会一次搬完
+    void reserve(size_type n) {
+        if (n <= m_capacity)
+            return;
+        finishMigration();
+        startMigration(n);
+        finishMigration();
+    }
+
+    // modifier
+
+    void push_back(T const& value) { emplace_back(value); }
+    void push_back(T&& value) { emplace_back(std::move(value)); }
+
+    template <typename... Args> reference emplace_back(Args&&... args) {
+        if (m_size == m_capacity) [[unlikely]] {
+            // 正常情况下此时上一轮早已搬完, 这里只是保险
+            finishMigration();
+            startMigration(std::max<size_type>(8, m_capacity * 2));
+        }
+        T* p = m_data + m_size;
+        AllocTraits::construct(m_alloc, p, std::forward<Args>(args)...);
+        m_size++;
+        if (m_old)
+            migrate(kStep);
+        return *p;
+    }
+
+    void pop_back() noexcept {
+        size_type i = m_size - 1;
+        if (i >= m_moved && i < m_oldSize) {
+            AllocTraits::destroy(m_alloc, m_old + i);
+            m_oldSize--;
+            if (m_moved == m_oldSize)
+                releaseOld();
+        } else {
+            AllocTraits::destroy(m_alloc, m_data + i);
+        }
+        m_size--;
+    }
+
+    void clear() noexcept {
+        while (m_size)
+            pop_back();
+    }
+
+    void finishMigration() {
+        if (m_old)
+            migrate(m_oldSize - m_moved);
+    }
+
+  private:
+    void startMigration(size_type n) {
+        T* fresh = AllocTraits::allocate(m_alloc, n);
+        m_old = m_data;
+        m_oldCapacity = m_capacity;
+        m_oldSize = m_size;
+        m_moved = 0;
+        m_data = fresh;
+        m_capacity = n;
+        if (m_oldSize == 0)
+            releaseOld();
+    }
+
+    void migrate(size_type n) {
+        size_type end = std::min(m_oldSize, m_moved + n);
+        for (; m_moved != end; m_moved++) {
+            AllocTraits::construct(m_alloc, m_data + m_moved,
+                                   std::move_if_noexcept(m_old[m_moved]));
+            AllocTraits::destroy(m_alloc, m_old + m_moved);
+        }
+        if (m_moved == m_oldSize)
+            releaseOld();
+    }
+
+    void releaseOld() noexcept {
+        if (m_old)
+            AllocTraits::deallocate(m_alloc, m_old, m_oldCapacity);
+        m_old = nullptr;
+        m_oldCapacity = 0;
+        m_oldSize = 0;
+        m_moved = 0;
+    }
+
+    T* m_data = nullptr;
+    size_type m_size = 0;
+    size_type m_capacity = 0;
+    // 搬家中的旧缓冲区, [m_moved, m_oldSize) 还在旧缓冲区里
+    T* m_old = nullptr;
+    size_type m_oldCapacity = 0;
+    size_type m_oldSize = 0;
+    size_type m_moved = 0;
+    [[no_unique_address]] Alloc m_alloc;
+};
+} // namespace lstl
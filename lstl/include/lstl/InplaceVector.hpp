@@ -0,0 +1,379 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace lstl {
+namespace detail {
+// 元素放在union里, 运行期不初始化, 也不要求T可默认构造.
+// 常量求值时要先激活union成员, 只有平凡类型支持, 用值初始化逐个赋值
+template <typename T, std::size_t N> struct InplaceStorage {
+    union {
+        T m_elems[N];
+    };
+
+    constexpr InplaceStorage() noexcept {
+        if constexpr (std::is_trivial_v<T>) {
+            if (std::is_constant_evaluated()) {
+                for (std::size_t i = 0; i != N; i++)
+                    m_elems[i] = T();
+            }
+        }
+    }
+    constexpr ~InplaceStorage() {}
+
+    constexpr T* data() noexcept { return m_elems; }
+    constexpr T const* data() const noexcept { return m_elems; }
+};
+
+template <typename T> struct InplaceStorage<T, 0> {
+    constexpr T* data() noexcept { return nullptr; }
+    constexpr T const* data() const noexcept { return nullptr; }
+};
+} // namespace detail
+
+// 容量固定为N, 元素存放在对象内部, 不分配堆内存
+// 接口与Vector一致(assign/insert/emplace/erase/swap 签名相同),
+// 超出容量时push_back/insert抛std::bad_alloc, try_push_back返回nullptr
+template <typename T, std::size_t N> class InplaceVector {
+  public:
+    using value_type = T;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using pointer = T*;
+    using const_pointer = T const*;
+    using reference = T&;
+    using const_reference = T const&;
+    using iterator = T*;
+    using const_iterator = T const*;
+    using reverse_iterator = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+  private:
+    static constexpr bool kTrivial = std::is_trivial_v<T>;
+
+    detail::InplaceStorage<T, N> m_storage;
+    size_type m_size = 0;
+
+  public:
+    constexpr InplaceVector() noexcept = default;
+
+    constexpr explicit InplaceVector(size_type n) {
+        checkCapacity(n);
+        for (size_type i = 0; i != n; i++)
+            unchecked_emplace_back();
+    }
+
+    constexpr InplaceVector(size_type n, T const& value) {
+        checkCapacity(n);
+        for (size_type i = 0; i != n; i++)
+            unchecked_emplace_back(value);
+    }
+
+    constexpr InplaceVector(std::initializer_list<T> lst) {
+        checkCapacity(lst.size());
+        for (auto const& value : lst)
+            unchecked_emplace_back(value);
+    }
+
+    constexpr InplaceVector(InplaceVector const& that) {
+        for (auto const& value : that)
+            unchecked_emplace_back(value);
+    }
+
+    constexpr InplaceVector(InplaceVector&& that) noexcept(
+        std::is_nothrow_move_constructible_v<T>) {
+        for (auto& value : that)
+            unchecked_emplace_back(std::move(value));
+    }
+
+    constexpr ~InplaceVector() { clear(); }
+
+    constexpr InplaceVector& operator=(InplaceVector const& that) {
+        if (&that == this) [[unlikely]]
+            return *this;
+        clear();
+        for (auto const& value : that)
+            unchecked_emplace_back(value);
+        return *this;
+    }
+
+    constexpr InplaceVector& operator=(std::initializer_list<T> lst) {
+        assign(lst);
+        return *this;
+    }
+
+    constexpr InplaceVector& operator=(InplaceVector&& that) noexcept(
+        std::is_nothrow_move_constructible_v<T>) {
+        if (&that == this) [[unlikely]]
+            return *this;
+        clear();
+        for (auto& value : that)
+            unchecked_emplace_back(std::move(value));
+        return *this;
+    }
+
+    // assign
+
+    constexpr void assign(size_type n, T const& value) {
+        checkCapacity(n);
+        T copy = value; // value 可能是自身的元素
+        clear();
+        for (size_type i = 0; i != n; i++)
+            unchecked_emplace_back(copy);
+    }
+
+    template <std::input_iterator InputIterator>
+    constexpr void assign(InputIterator first, InputIterator last) {
+        clear();
+        for (; first != last; ++first)
+            emplace_back(*first);
+    }
+
+    constexpr void assign(std::initializer_list<T> lst) {
+        checkCapacity(lst.size());
+        assign(lst.begin(), lst.end());
+    }
+
+    // at
+
+    constexpr reference at(size_type i) {
+        if (i >= m_size) [[unlikely]]
+            throw std::out_of_range("inplace_vector::at out_of_range");
+        return data()[i];
+    }
+    constexpr const_reference at(size_type i) const {
+        if (i >= m_size) [[unlikely]]
+            throw std::out_of_range("inplace_vector::at out_of_range");
+        return data()[i];
+    }
+
+    constexpr reference operator[](size_type i) noexcept { return data()[i]; }
+    constexpr const_reference operator[](size_type i) const noexcept {
+        return data()[i];
+    }
+
+    constexpr reference front() noexcept { return data()[0]; }
+    constexpr const_reference front() const noexcept { return data()[0]; }
+    constexpr reference back() noexcept { return data()[m_size - 1]; }
+    constexpr const_reference back() const noexcept {
+        return data()[m_size - 1];
+    }
+
+    constexpr T* data() noexcept { return m_storage.data(); }
+    constexpr T const* data() const noexcept { return m_storage.data(); }
+
+    // begin & end
+
+    constexpr iterator begin() noexcept { return data(); }
+    constexpr const_iterator begin() const noexcept { return data(); }
+    constexpr const_iterator cbegin() const noexcept { return data(); }
+    constexpr iterator end() noexcept { return data() + m_size; }
+    constexpr const_iterator end() const noexcept { return data() + m_size; }
+    constexpr const_iterator cend() const noexcept { return data() + m_size; }
+
+    constexpr reverse_iterator rbegin() noexcept {
+        return std::make_reverse_iterator(end());
+    }
+    constexpr const_reverse_iterator rbegin() const noexcept {
+        return std::make_reverse_iterator(end());
+    }
+    constexpr reverse_iterator rend() noexcept {
+        return std::make_reverse_iterator(begin());
+    }
+    constexpr const_reverse_iterator rend() const noexcept {
+        return std::make_reverse_iterator(begin());
+    }
+
+    // about size
+
+    constexpr bool empty() const noexcept { return m_size == 0; }
+    constexpr size_type size() const noexcept { return m_size; }
+    static constexpr size_type capacity() noexcept { return N; }
+    static constexpr size_type max_size() noexcept { return N; }
+
+    // modifier
+
+    template <typename... Args>
+    constexpr reference emplace_back(Args&&... args) {
+        if (m_size == N) [[unlikely]]
+            throw std::bad_alloc();
+        return unchecked_emplace_back(std::forward<Args>(args)...);
+    }
+    constexpr void push_back(T const& value) { emplace_back(value); }
+    constexpr void push_back(T&& value) { emplace_back(std::move(value)); }
+
+    // 满了返回nullptr, 不抛异常
+    template <typename... Args>
+    constexpr T* try_emplace_back(Args&&... args) {
+        if (m_size == N) [[unlikely]]
+            return nullptr;
+        return &unchecked_emplace_back(std::forward<Args>(args)...);
+    }
+    constexpr T* try_push_back(T const& value) {
+        return try_emplace_back(value);
+    }
+    constexpr T* try_push_back(T&& value) {
+        return try_emplace_back(std::move(value));
+    }
+
+    // 调用者保证 size() < capacity()
+    template <typename... Args>
+    constexpr reference unchecked_emplace_back(Args&&... args) {
+        T* p = data() + m_size;
+        if constexpr (kTrivial) {
+            if (std::is_constant_evaluated()) {
+                *p = T(std::forward<Args>(args)...);
+                m_size++;
+                return *p;
+            }
+        }
+        std::construct_at(p, std::forward<Args>(args)...);
+        m_size++;
+        return *p;
+    }
+
+    constexpr void pop_back() noexcept {
+        m_size--;
+        if constexpr (!kTrivial)
+            std::destroy_at(data() + m_size);
+    }
+
+    constexpr void clear() noexcept {
+        if constexpr (!kTrivial) {
+            for (size_type i = 0; i != m_size; i++)
+                std::destroy_at(data() + i);
+        }
+        m_size = 0;
+    }
+
+    constexpr void resize(size_type n) {
+        checkCapacity(n);
+        while (m_size > n)
+            pop_back();
+        while (m_size < n)
+            unchecked_emplace_back();
+    }
+
+    constexpr void resize(size_type n, T const& value) {
+        checkCapacity(n);
+        while (m_size > n)
+            pop_back();
+        while (m_size < n)
+            unchecked_emplace_back(value);
+    }
+
+    // 插入的元素先追加到末尾再转到位置上, 所以value可以是自身的元素;
+    // 超出容量时抛std::bad_alloc, 内容不变
+
+    template <typename... Args>
+    constexpr iterator emplace(const_iterator it, Args&&... args) {
+        auto i = static_cast<size_type>(it - data());
+        emplace_back(std::forward<Args>(args)...);
+        std::rotate(begin() + i, end() - 1, end());
+        return begin() + i;
+    }
+
+    constexpr iterator insert(const_iterator it, T const& value) {
+        return emplace(it, value);
+    }
+    constexpr iterator insert(const_iterator it, T&& value) {
+        return emplace(it, std::move(value));
+    }
+
+    constexpr iterator insert(const_iterator it, size_type n,
+                              T const& value) {
+        auto i = static_cast<size_type>(it - data());
+        checkCapacity(m_size + n);
+        size_type old = m_size;
+        try {
+            for (size_type k = 0; k != n; k++)
+                unchecked_emplace_back(value);
+        } catch (...) {
+            truncate(old);
+            throw;
+        }
+        std::rotate(begin() + i, begin() + old, end());
+        return begin() + i;
+    }
+
+    template <std::input_iterator InputIterator>
+    constexpr iterator insert(const_iterator it, InputIterator first,
+                              InputIterator last) {
+        auto i = static_cast<size_type>(it - data());
+        size_type old = m_size;
+        try {
+            for (; first != last; ++first)
+                emplace_back(*first);
+        } catch (...) {
+            truncate(old);
+            throw;
+        }
+        std::rotate(begin() + i, begin() + old, end());
+        return begin() + i;
+    }
+
+    constexpr iterator insert(const_iterator it,
+                              std::initializer_list<T> lst) {
+        checkCapacity(m_size + lst.size());
+        return insert(it, lst.begin(), lst.end());
+    }
+
+    constexpr iterator erase(const_iterator it) noexcept(
+        std::is_nothrow_move_assignable_v<T>) {
+        size_type i = static_cast<size_type>(it - data());
+        for (size_type j = i + 1; j != m_size; j++)
+            data()[j - 1] = std::move(data()[j]);
+        pop_back();
+        return data() + i;
+    }
+
+    constexpr iterator
+    erase(const_iterator first,
+          const_iterator last) noexcept(std::is_nothrow_move_assignable_v<T>) {
+        auto i = static_cast<size_type>(first - data());
+        auto j = static_cast<size_type>(last - data());
+        std::move(begin() + j, end(), begin() + i);
+        truncate(m_size - (j - i));
+        return begin() + i;
+    }
+
+    // 元素存放在对象内部, 只能逐个交换, O(N)
+    constexpr void swap(InplaceVector& that) noexcept(
+        std::is_nothrow_move_constructible_v<T> &&
+        std::is_nothrow_swappable_v<T>) {
+        InplaceVector* shorter = this;
+        InplaceVector* longer = &that;
+        if (shorter->m_size > longer->m_size)
+            std::swap(shorter, longer);
+        std::swap_ranges(shorter->begin(), shorter->end(), longer->begin());
+        size_type n = shorter->m_size;
+        for (size_type i = n; i != longer->m_size; i++)
+            shorter->unchecked_emplace_back(std::move((*longer)[i]));
+        longer->truncate(n);
+    }
+
+    // comparison
+
+    constexpr bool operator==(InplaceVector const& that) const {
+        return std::equal(begin(), end(), that.begin(), that.end());
+    }
+
+  private:
+    constexpr void truncate(size_type n) noexcept {
+        while (m_size > n)
+            pop_back();
+    }
+
+    static constexpr void checkCapacity(size_type n) {
+        if (n > N) [[unlikely]]
+            throw std::bad_alloc();
+    }
+};
+} // namespace lstl
@@ -0,0 +1,198 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+
+// 容器的分配/拷贝计数, 默认编译掉
+// 定义 LSTL_INSTRUMENT 后容器内部的 LSTL_COUNT 才会计数;
+// 定义 LSTL_USDT 且系统有 <sys/sdt.h> 时额外产生USDT探针(provider为lstl),
+// 可以用 bpftrace/perf 挂上去按调用栈归因
+#if defined(LSTL_USDT) && __has_include(<sys/sdt.h>)
+#include <sys/sdt.h>
+#define LSTL_PROBE(name, a, b) DTRACE_PROBE2(lstl, name, a, b)
+#else
+#define LSTL_PROBE(name, a, b) ((void)0)
+#endif
+
+#if defined(LSTL_INSTRUMENT)
+#define LSTL_COUNT(Tag, field, n)                                              \
+    ::lstl::instrument::counters<Tag>().field.fetch_add(                       \
+        static_cast<std::uint64_t>(n), std::memory_order_relaxed)
+#else
+#define LSTL_COUNT(Tag, field, n) ((void)0)
+#endif
+
+namespace lstl::instrument {
+struct Snapshot {
+    char const* name;
+    std::uint64_t allocations;
+    std::uint64_t deallocations;
+    std::uint64_t bytesRequested;
+    std::uint64_t bytesFreed;
+    std::uint64_t reallocations; // Vector::reserve 引起的搬家
+    std::uint64_t elementsMoved;
+    std::uint64_t elementsCopied;
+    std::uint64_t shrinkToFit;
+    std::uint64_t nodeAllocations; // 树容器的节点分配
+};
+
+struct Counters {
+    char const* m_name;
+    Counters* m_next = nullptr;
+    std::atomic<std::uint64_t> allocations{0};
+    std::atomic<std::uint64_t> deallocations{0};
+    std::atomic<std::uint64_t> bytesRequested{0};
+    std::atomic<std::uint64_t> bytesFreed{0};
+    std::atomic<std::uint64_t> reallocations{0};
+    std::atomic<std::uint64_t> elementsMoved{0};
+    std::atomic<std::uint64_t> elementsCopied{0};
+    std::atomic<std::uint64_t> shrinkToFit{0};
+    std::atomic<std::uint64_t> nodeAllocations{0};
+
+    explicit Counters(char const* name) : m_name(name) {}
+
+    Snapshot snapshot() const noexcept {
+        constexpr auto r = std::memory_order_relaxed;
+        return Snapshot{m_name,
+                        allocations.load(r),
+                        deallocations.load(r),
+                        bytesRequested.load(r),
+                        bytesFreed.load(r),
+                        reallocations.load(r),
+                        elementsMoved.load(r),
+                        elementsCopied.load(r),
+                        shrinkToFit.load(r),
+                        nodeAllocations.load(r)};
+    }
+
+    void reset() noexcept {
+        constexpr auto r = std::memory_order_relaxed;
+        allocations.store(0, r);
+        deallocations.store(0, r);
+        bytesRequested.store(0, r);
+        bytesFreed.store(0, r);
+        reallocations.store(0, r);
+        elementsMoved.store(0, r);
+        elementsCopied.store(0, r);
+        shrinkToFit.store(0, r);
+        nodeAllocations.store(0, r);
+    }
+};
+
+// 所有用过的计数器挂在一条链表上, 供report遍历
+inline std::atomic<Counters*>& registry() noexcept {
+    static std::atomic<Counters*> s_head{nullptr};
+    return s_head;
+}
+
+// 每个Tag一组计数器, Tag需要提供 static constexpr char const* name
+template <typename Tag> Counters& counters() noexcept {
+    static Counters* s_counters = [] {
+        auto* c = new Counters(Tag::name);
+        c->m_next = registry().load(std::memory_order_relaxed);
+        while (!registry().compare_exchange_weak(c->m_next, c,
+                                                 std::memory_order_release,
+                                                 std::memory_order_relaxed)) {
+        }
+        return c;
+    }();
+    return *s_counters;
+}
+
+template <typename Tag> Snapshot snapshot() noexcept {
+    return counters<Tag>().snapshot();
+}
+
+// 按名字查找, 没有用过的Tag返回全0
+inline Snapshot snapshot(char const* name) noexcept {
+    for (Counters* c = registry().load(std::memory_order_acquire); c;
+         c = c->m_next) {
+        if (std::strcmp(c->m_name, name) == 0)
+            return c->snapshot();
+    }
+    return Snapshot{name, 0, 0, 0, 0, 0, 0, 0, 0, 0};
+}
+
+inline void reset() noexcept {
+    for (Counters* c = registry().load(std::memory_order_acquire); c;
+         c = c->m_next)
+        c->reset();
+}
+
+inline void report(std::FILE* out = stderr) {
+    std::fprintf(out, "%-16s %12s %12s %14s %14s %10s %12s %12s %8s %10s\n",
+                 "container", "allocs", "deallocs", "bytes_req",
+                 "bytes_freed", "reallocs", "moved", "copied", "shrink",
+                 "nodes");
+    for (Counters* c = registry().load(std::memory_order_acquire); c;
+         c = c->m_next) {
+        Snapshot s = c->snapshot();
+        std::fprintf(out,
+                     "%-16s %12llu %12llu %14llu %14llu %10llu %12llu %12llu "
+                     "%8llu %10llu\n",
+                     s.name, static_cast<unsigned long long>(s.allocations),
+                     static_cast<unsigned long long>(s.deallocations),
+                     static_cast<unsigned long long>(s.bytesRequested),
+                     static_cast<unsigned long long>(s.bytesFreed),
+                     static_cast<unsigned long long>(s.reallocations),
+                     static_cast<unsigned long long>(s.elementsMoved),
+                     static_cast<unsigned long long>(s.elementsCopied),
+                     static_cast<unsigned long long>(s.shrinkToFit),
+                     static_cast<unsigned long long>(s.nodeAllocations));
+    }
+}
+
+struct VectorTag {
+    static constexpr char const* name = "Vector";
+};
+struct SetTag {
+    static constexpr char const* name = "Set";
+};
+struct TrackingTag {
+    static constexpr char const* name = "TrackingAllocator";
+};
+
+// 不受 LSTL_INSTRUMENT 控制, 用了就计数
+// 给不同调用点传不同的Tag, 就能把内存开销归到具体的调用点上
+template <typename T, typename Tag = TrackingTag,
+          typename Base = std::allocator<T>>
+struct TrackingAllocator : Base {
+    using value_type = T;
+    using BaseTraits = std::allocator_traits<Base>;
+
+    template <typename U> struct rebind {
+        using other = TrackingAllocator<
+            U, Tag, typename BaseTraits::template rebind_alloc<U>>;
+    };
+
+    TrackingAllocator() = default;
+    explicit TrackingAllocator(Base const& base) : Base(base) {}
+    template <typename U, typename B>
+    TrackingAllocator(TrackingAllocator<U, Tag, B> const& that) noexcept
+        : Base(static_cast<B const&>(that)) {}
+
+    T* allocate(std::size_t n) {
+        Counters& c = counters<Tag>();
+        c.allocations.fetch_add(1, std::memory_order_relaxed);
+        c.bytesRequested.fetch_add(n * sizeof(T), std::memory_order_relaxed);
+        LSTL_PROBE(alloc, n * sizeof(T), Tag::name);
+        return BaseTraits::allocate(*static_cast<Base*>(this), n);
+    }
+
+    void deallocate(T* p, std::size_t n) noexcept {
+        Counters& c = counters<Tag>();
+        c.deallocations.fetch_add(1, std::memory_order_relaxed);
+        c.bytesFreed.fetch_add(n * sizeof(T), std::memory_order_relaxed);
+        LSTL_PROBE(dealloc, n * sizeof(T), Tag::name);
+        BaseTraits::deallocate(*static_cast<Base*>(this), p, n);
+    }
+
+    template <typename U, typename B>
+    bool operator==(TrackingAllocator<U, Tag, B> const& that) const noexcept {
+        return static_cast<Base const&>(*this) == static_cast<B const&>(that);
+    }
+};
+} // namespace lstl::instrument
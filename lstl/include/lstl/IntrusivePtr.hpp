@@ -0,0 +1,143 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+#include "lstl/UniquePtr.hpp"
+
+namespace lstl {
+// 引用计数策略
+struct AtomicRefCount {
+    std::atomic<long> m_count{0};
+
+    void incref() noexcept { m_count.fetch_add(1, std::memory_order_relaxed); }
+    // 返回true表示计数归零
+    bool decref() noexcept {
+        return m_count.fetch_sub(1, std::memory_order_acq_rel) == 1;
+    }
+    long count() const noexcept {
+        return m_count.load(std::memory_order_relaxed);
+    }
+};
+
+struct PlainRefCount {
+    long m_count = 0;
+
+    void incref() noexcept { ++m_count; }
+    bool decref() noexcept { return --m_count == 0; }
+    long count() const noexcept { return m_count; }
+};
+
+// CRTP基类, 计数直接放在对象里, 省掉SpControlBlock那次额外的分配和cache miss
+// 计数归零时调用对象自己保存的Deleter, 可以换成归还到池子的销毁钩子
+// (比如 PoolDeleter, 见 ObjectPool::acquireIntrusive).
+// 无状态的Deleter不占空间.
+template <typename T, typename Policy = AtomicRefCount,
+          typename Deleter = DefaultDeleter<T>>
+class RefCounted {
+  public:
+    long use_count() const noexcept { return m_refs.count(); }
+
+  protected:
+    // 有状态的Deleter(比如 PoolDeleter)必须显式传入,
+    // 否则默认构造出来的Deleter在计数归零时才会出错
+    RefCounted() noexcept
+        requires std::is_empty_v<Deleter>
+    = default;
+    explicit RefCounted(Deleter deleter) noexcept
+        : m_deleter(std::move(deleter)) {}
+    // 拷贝对象不拷贝计数, 也不拷贝Deleter: 新对象不属于原来的池子
+    RefCounted(RefCounted const&) noexcept
+        requires std::is_empty_v<Deleter>
+        : m_deleter() {}
+    // 有状态的Deleter拷贝时要给出新对象自己的Deleter
+    RefCounted(RefCounted const&, Deleter deleter) noexcept
+        : m_deleter(std::move(deleter)) {}
+    RefCounted& operator=(RefCounted const&) noexcept { return *this; }
+    ~RefCounted() = default;
+
+  private:
+    mutable Policy m_refs;
+    [[no_unique_address]] Deleter m_deleter{};
+
+    // hidden friend, 通过ADL被IntrusivePtr找到
+    friend void intrusivePtrAddRef(RefCounted const* p) noexcept {
+        p->m_refs.incref();
+    }
+    friend void intrusivePtrRelease(RefCounted const* p) noexcept {
+        if (p->m_refs.decref()) {
+            // Deleter 随对象一起销毁, 先拷出来
+            Deleter deleter = p->m_deleter;
+            deleter(static_cast<T*>(const_cast<RefCounted*>(p)));
+        }
+    }
+};
+
+// 只有一个指针大小的智能指针, 要求T提供
+// intrusivePtrAddRef(T*) 和 intrusivePtrRelease(T*), 继承RefCounted即可
+template <typename T> class IntrusivePtr {
+  public:
+    using element_type = T;
+    using pointer = T*;
+
+    IntrusivePtr() noexcept : m_p(nullptr) {}
+    IntrusivePtr(std::nullptr_t) noexcept : m_p(nullptr) {}
+    // 可以直接从this构造; addRef为false时接管一个已经计过数的引用
+    explicit IntrusivePtr(pointer p, bool addRef = true) noexcept : m_p(p) {
+        if (m_p && addRef)
+            intrusivePtrAddRef(m_p);
+    }
+    IntrusivePtr(IntrusivePtr const& that) noexcept : m_p(that.m_p) {
+        if (m_p)
+            intrusivePtrAddRef(m_p);
+    }
+    IntrusivePtr(IntrusivePtr&& that) noexcept
+        : m_p(std::exchange(that.m_p, nullptr)) {}
+
+    template <typename U>
+    IntrusivePtr(IntrusivePtr<U> const& that) noexcept : m_p(that.get()) {
+        if (m_p)
+            intrusivePtrAddRef(m_p);
+    }
+
+    ~IntrusivePtr() {
+        if (m_p)
+            intrusivePtrRelease(m_p);
+    }
+
+    IntrusivePtr& operator=(IntrusivePtr const& that) noexcept {
+        IntrusivePtr(that).swap(*this);
+        return *this;
+    }
+    IntrusivePtr& operator=(IntrusivePtr&& that) noexcept {
+        IntrusivePtr(std::move(that)).swap(*this);
+        return *this;
+    }
+
+    void reset() noexcept { IntrusivePtr().swap(*this); }
+    void reset(pointer p) noexcept { IntrusivePtr(p).swap(*this); }
+    // 放弃所有权但不减计数
+    pointer detach() noexcept { return std::exchange(m_p, nullptr); }
+    void swap(IntrusivePtr& that) noexcept { std::swap(m_p, that.m_p); }
+
+    pointer get() const noexcept { return m_p; }
+    T& operator*() const noexcept { return *m_p; }
+    pointer operator->() const noexcept { return m_p; }
+    explicit operator bool() const noexcept { return m_p != nullptr; }
+
+    template <typename U>
+    bool operator==(IntrusivePtr<U> const& that) const noexcept {
+        return m_p == that.get();
+    }
+    bool operator==(std::nullptr_t) const noexcept { return m_p == nullptr; }
+
+  private:
+    pointer m_p;
+};
+
+template <typename T, typename... Args>
+IntrusivePtr<T> makeIntrusive(Args&&... args) {
+    return IntrusivePtr<T>(new T(std::forward<Args>(args)...));
+}
+} // namespace lstl
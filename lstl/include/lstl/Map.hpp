@@ -1,4 +1,8 @@
 #pragma once
+#include <cstddef>
+
+#include "lstl/Instrument.hpp"
+
 namespace lstl {
 struct Node {
     Node* parent;
@@ -12,6 +16,12 @@ struct Set {
     Node* root = nullptr;
     Node* height = 0;
 
+    Set() = default;
+    // 节点归Set所有, 不能浅拷贝
+    Set(Set const&) = delete;
+    Set& operator=(Set const&) = delete;
+    ~Set() { clear(); }
+
     Node* find(int value) {
         Node* current = root;
         while (current) {
@@ -29,6 +39,9 @@ struct Set {
     }
 
     bool insert(int value) {
+        LSTL_COUNT(instrument::SetTag, nodeAllocations, 1);
+        LSTL_COUNT(instrument::SetTag, bytesRequested, sizeof(Node));
+        LSTL_PROBE(set_node_alloc, sizeof(Node), value);
         Node* node = new Node{};
         node->value = value;
         node->balance = 0;
@@ -63,6 +76,29 @@ struct Set {
         return true;
     }
 
+    // 不递归, 左子树不空时右旋, 否则释放当前节点再走右边
+    void clear() {
+        Node* current = root;
+        while (current) {
+            if (Node* left = current->left) {
+                current->left = left->right;
+                left->right = current;
+                current = left;
+            } else {
+                Node* next = current->right;
+                delete current;
+                current = next;
+            }
+        }
+        root = nullptr;
+    }
+
+    // keys 严格递增, 以中位数为根递归建树, 深度为 O(log n)
+    void assign_sorted(int const* keys, std::size_t n) {
+        clear();
+        root = build_sorted(keys, n, nullptr);
+    }
+
     void left_rotate(Node*& ptr) {
         Node* N1 = ptr;
         Node* N2 = ptr->right;
@@ -80,5 +116,21 @@ struct Set {
         N1->left = N3;
         N2->right = N1;
     }
+
+  private:
+    Node* build_sorted(int const* keys, std::size_t n, Node* parent) {
+        if (n == 0)
+            return nullptr;
+        LSTL_COUNT(instrument::SetTag, nodeAllocations, 1);
+        LSTL_COUNT(instrument::SetTag, bytesRequested, sizeof(Node));
+        LSTL_PROBE(set_node_alloc, sizeof(Node), keys[n / 2]);
+        Node* node = new Node{};
+        node->value = keys[n / 2];
+        node->balance = 0;
+        node->parent = parent;
+        node->left = build_sorted(keys, n / 2, node);
+        node->right = build_sorted(keys + n / 2 + 1, n - n / 2 - 1, node);
+        return node;
+    }
 };
 } // namespace lstl
@@ -0,0 +1,222 @@
+#pragma once
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <utility>
+
+#include "lstl/IntrusivePtr.hpp"
+#include "lstl/UniquePtr.hpp"
+#include "lstl/Vector.hpp"
+
+namespace lstl {
+// 对象归还到池子时的处理方式
+enum class PoolRecycle {
+    Destroy, // 调用析构函数, 下次acquire重新构造
+    Reset,   // 调用 T::reset(), 对象保持构造状态, 下次acquire直接复用
+};
+
+struct PoolStats {
+    std::size_t live;      // 当前借出的对象数
+    std::size_t highWater; // 历史最大借出数
+    std::size_t capacity;  // 已分配的槽位数
+    std::size_t slabs;     // 已分配的slab数
+};
+
+template <typename T, PoolRecycle Recycle> class ObjectPool;
+
+// 把对象还给池子而不是delete
+template <typename T, PoolRecycle Recycle = PoolRecycle::Destroy>
+struct PoolDeleter {
+    ObjectPool<T, Recycle>* m_pool;
+
+    void operator()(T* p) const noexcept { m_pool->release(p); }
+};
+
+// 按slab预分配T的对象池, acquire返回带PoolDeleter的UniquePtr
+// 空闲链表按线程分片, 每个线程固定落在一个分片上, 归还时也还到自己的分片,
+// 分片之间用cache line隔开, 避免所有线程争同一把锁
+template <typename T, PoolRecycle Recycle = PoolRecycle::Destroy>
+class ObjectPool {
+    struct Slot {
+        alignas(T) unsigned char m_storage[sizeof(T)];
+        Slot* m_next = nullptr;
+        bool m_constructed = false;
+    };
+
+    struct alignas(64) Shard {
+        std::mutex m_lock;
+        Slot* m_free = nullptr;
+    };
+
+    static constexpr std::size_t kShards = 8;
+
+  public:
+    using value_type = T;
+    using Deleter = PoolDeleter<T, Recycle>;
+    using Handle = UniquePtr<T, Deleter>;
+
+    explicit ObjectPool(std::size_t slabSize = 64, std::size_t reserved = 0)
+        : m_slabSize(slabSize ? slabSize : 1) {
+        while (m_capacity.load(std::memory_order_relaxed) < reserved) {
+            Slot* s = grow(m_shards[0]);
+            s->m_next = m_shards[0].m_free;
+            m_shards[0].m_free = s;
+        }
+    }
+
+    ObjectPool(ObjectPool const&) = delete;
+    ObjectPool& operator=(ObjectPool const&) = delete;
+
+    // 析构前所有借出的对象必须已经归还
+    ~ObjectPool() {
+        assert(m_live.load() == 0 && "ObjectPool destroyed with live objects");
+        if constexpr (Recycle == PoolRecycle::Reset) {
+            for (auto& slab : m_slabs) {
+                for (std::size_t i = 0; i != m_slabSize; i++) {
+                    if (slab[i].m_constructed)
+                        std::destroy_at(object(&slab[i]));
+                }
+            }
+        }
+    }
+
+    // Reset模式下对象只在第一次借出时默认构造, 之后复用的是归还时reset()过的
+    // 对象, 构造参数无处可用, 所以只接受无参调用
+    template <typename... Args>
+        requires(Recycle == PoolRecycle::Destroy || sizeof...(Args) == 0)
+    Handle acquire(Args&&... args) {
+        return Handle(take(std::forward<Args>(args)...), Deleter{this});
+    }
+
+    // 引用计数的借出: T 继承 RefCounted<T, Policy, PoolDeleter<T, Recycle>>,
+    // 构造函数的第一个参数是Deleter, 转交给RefCounted. 计数归零时回到池子
+    template <typename... Args>
+        requires(Recycle == PoolRecycle::Destroy || sizeof...(Args) == 0)
+    IntrusivePtr<T> acquireIntrusive(Args&&... args) {
+        return IntrusivePtr<T>(
+            take(Deleter{this}, std::forward<Args>(args)...));
+    }
+
+    void release(T* p) noexcept {
+        if constexpr (Recycle == PoolRecycle::Reset)
+            p->reset();
+        else
+            std::destroy_at(p);
+        push(reinterpret_cast<Slot*>(p));
+        m_live.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    PoolStats stats() const noexcept {
+        return PoolStats{m_live.load(std::memory_order_relaxed),
+                         m_highWater.load(std::memory_order_relaxed),
+                         m_capacity.load(std::memory_order_relaxed),
+                         m_slabCount.load(std::memory_order_relaxed)};
+    }
+
+  private:
+    static T* object(Slot* s) noexcept {
+        return std::launder(reinterpret_cast<T*>(s->m_storage));
+    }
+
+    // 取一个槽位并得到可用的对象; Reset模式下args只在第一次构造时使用
+    template <typename... Args> T* take(Args&&... args) {
+        Slot* s = pop();
+        T* p;
+        if constexpr (Recycle == PoolRecycle::Reset) {
+            if (s->m_constructed) {
+                p = object(s);
+            } else {
+                p = construct(s, std::forward<Args>(args)...);
+                s->m_constructed = true;
+            }
+        } else {
+            p = construct(s, std::forward<Args>(args)...);
+        }
+        std::size_t live = m_live.fetch_add(1, std::memory_order_relaxed) + 1;
+        std::size_t high = m_highWater.load(std::memory_order_relaxed);
+        while (live > high && !m_highWater.compare_exchange_weak(
+                                  high, live, std::memory_order_relaxed)) {
+        }
+        return p;
+    }
+
+    template <typename... Args> T* construct(Slot* s, Args&&... args) {
+        try {
+            return std::construct_at(reinterpret_cast<T*>(s->m_storage),
+                                     std::forward<Args>(args)...);
+        } catch (...) {
+            push(s);
+            throw;
+        }
+    }
+
+    Shard& myShard() noexcept {
+        static std::atomic<std::size_t> s_next{0};
+        static thread_local const std::size_t idx =
+            s_next.fetch_add(1, std::memory_order_relaxed) % kShards;
+        return m_shards[idx];
+    }
+
+    Slot* pop() {
+        Shard& mine = myShard();
+        {
+            std::lock_guard lock(mine.m_lock);
+            if (Slot* s = mine.m_free) {
+                mine.m_free = s->m_next;
+                return s;
+            }
+        }
+        // 自己的分片空了, 先从别的分片偷, 偷不到再分配新slab
+        for (Shard& other : m_shards) {
+            if (&other == &mine)
+                continue;
+            std::unique_lock lock(other.m_lock, std::try_to_lock);
+            if (lock && other.m_free) {
+                Slot* s = other.m_free;
+                other.m_free = s->m_next;
+                return s;
+            }
+        }
+        return grow(mine);
+    }
+
+    void push(Slot* s) noexcept {
+        Shard& mine = myShard();
+        std::lock_guard lock(mine.m_lock);
+        s->m_next = mine.m_free;
+        mine.m_free = s;
+    }
+
+    // 分配一个新slab, 第一个槽位直接返回, 其余挂到shard上
+    Slot* grow(Shard& shard) {
+        Slot* slots;
+        {
+            std::lock_guard lock(m_slabLock);
+            m_slabs.push_back(makeUnique<Slot[]>(m_slabSize));
+            slots = m_slabs.back().get();
+        }
+        m_slabCount.fetch_add(1, std::memory_order_relaxed);
+        m_capacity.fetch_add(m_slabSize, std::memory_order_relaxed);
+        for (std::size_t i = 1; i + 1 < m_slabSize; i++)
+            slots[i].m_next = &slots[i + 1];
+        if (m_slabSize > 1) {
+            std::lock_guard lock(shard.m_lock);
+            slots[m_slabSize - 1].m_next = shard.m_free;
+            shard.m_free = &slots[1];
+        }
+        return &slots[0];
+    }
+
+    Shard m_shards[kShards];
+    std::size_t m_slabSize;
+    std::mutex m_slabLock;
+    Vector<UniquePtr<Slot[]>> m_slabs;
+    std::atomic<std::size_t> m_slabCount{0};
+    std::atomic<std::size_t> m_capacity{0};
+    std::atomic<std::size_t> m_live{0};
+    std::atomic<std::size_t> m_highWater{0};
+};
+} // namespace lstl
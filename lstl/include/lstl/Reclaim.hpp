@@ -0,0 +1,339 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+
+#include "lstl/UniquePtr.hpp"
+#include "lstl/Vector.hpp"
+
+namespace lstl {
+// 无锁结构的延迟释放
+//
+// ebr: epoch-based reclamation. 读侧只需在Guard的构造/析构里各写一次
+//      线程本地的epoch, 开销远小于SharedPtr拷贝的原子加减;
+//      代价是某个线程长时间持有Guard时, 所有待释放的内存都会堆积.
+// hazard: hazard pointer. 每次读都要发布指针并重新校验, 比ebr贵一点,
+//      但未释放的内存数量有上界.
+
+// 待释放的对象, deleter只接受无状态的函数指针
+struct Retired {
+    void* m_ptr;
+    void (*m_deleter)(void*);
+    std::uint64_t m_epoch; // 仅ebr使用
+
+    void reclaim() const { m_deleter(m_ptr); }
+};
+
+namespace detail {
+template <typename T, typename Deleter> void retiredDelete(void* p) {
+    Deleter{}(static_cast<T*>(p));
+}
+
+// 线程退出时没来得及释放的对象交给其他线程处理
+struct OrphanList {
+    std::mutex m_lock;
+    Vector<Retired> m_items;
+
+    void adopt(Vector<Retired>& items) {
+        std::lock_guard lock(m_lock);
+        for (auto& r : items)
+            m_items.push_back(r);
+        items.clear();
+    }
+    void takeInto(Vector<Retired>& items) {
+        std::unique_lock lock(m_lock, std::try_to_lock);
+        if (!lock)
+            return;
+        for (auto& r : m_items)
+            items.push_back(r);
+        m_items.clear();
+    }
+};
+} // namespace detail
+
+namespace ebr {
+inline constexpr std::uint64_t kIdle = ~std::uint64_t(0);
+inline constexpr std::size_t kCollectThreshold = 64;
+
+struct alignas(64) Record {
+    std::atomic<std::uint64_t> m_epoch{kIdle};
+    std::atomic<bool> m_inUse{true};
+    Record* m_next = nullptr;
+};
+
+struct Domain {
+    alignas(64) std::atomic<std::uint64_t> m_epoch{0};
+    // 只增不删的线程记录链表, 线程退出后记录会被复用
+    alignas(64) std::atomic<Record*> m_head{nullptr};
+    detail::OrphanList m_orphans;
+
+    static Domain& instance() {
+        static Domain s_domain;
+        return s_domain;
+    }
+
+    Record* acquireRecord() {
+        for (Record* r = m_head.load(std::memory_order_acquire); r;
+             r = r->m_next) {
+            bool expected = false;
+            if (!r->m_inUse.load(std::memory_order_relaxed) &&
+                r->m_inUse.compare_exchange_strong(expected, true))
+                return r;
+        }
+        auto* r = new Record;
+        r->m_next = m_head.load(std::memory_order_relaxed);
+        while (!m_head.compare_exchange_weak(r->m_next, r,
+                                             std::memory_order_release,
+                                             std::memory_order_relaxed)) {
+        }
+        return r;
+    }
+
+    // 所有正在读的线程都已经观察到当前epoch时, 把全局epoch加一
+    bool tryAdvance() {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        std::uint64_t e = m_epoch.load(std::memory_order_relaxed);
+        for (Record* r = m_head.load(std::memory_order_acquire); r;
+             r = r->m_next) {
+            std::uint64_t local = r->m_epoch.load(std::memory_order_acquire);
+            if (local != kIdle && local != e)
+                return false;
+        }
+        return m_epoch.compare_exchange_strong(e, e + 1,
+                                               std::memory_order_acq_rel);
+    }
+};
+
+struct ThreadState {
+    Record* m_record = Domain::instance().acquireRecord();
+    unsigned m_nesting = 0;
+    bool m_collecting = false;
+    Vector<Retired> m_retired;
+
+    ~ThreadState() {
+        collect();
+        Domain::instance().m_orphans.adopt(m_retired);
+        m_record->m_epoch.store(kIdle, std::memory_order_release);
+        m_record->m_inUse.store(false, std::memory_order_release);
+    }
+
+    static ThreadState& local() {
+        static thread_local ThreadState s_state;
+        return s_state;
+    }
+
+    void pin() noexcept {
+        if (m_nesting++ != 0)
+            return;
+        Domain& d = Domain::instance();
+        m_record->m_epoch.store(d.m_epoch.load(std::memory_order_relaxed),
+                                std::memory_order_relaxed);
+        // 之后的读不能重排到epoch发布之前
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+    }
+
+    void unpin() noexcept {
+        if (--m_nesting == 0)
+            m_record->m_epoch.store(kIdle, std::memory_order_release);
+    }
+
+    // 全局epoch比对象退休时至少前进两次, 就没有读者还能看到它
+    // deleter 里可能再retire(比如析构时退休子节点), 所以先把列表换出来处理,
+    // 期间新退休的对象留在m_retired里, 也不会重入collect
+    void collect() {
+        if (m_collecting)
+            return;
+        m_collecting = true;
+        Domain& d = Domain::instance();
+        Vector<Retired> batch;
+        batch.swap(m_retired);
+        d.m_orphans.takeInto(batch);
+        d.tryAdvance();
+        std::uint64_t e = d.m_epoch.load(std::memory_order_acquire);
+        for (auto const& r : batch) {
+            if (r.m_epoch + 2 <= e)
+                r.reclaim();
+            else
+                m_retired.push_back(r);
+        }
+        m_collecting = false;
+    }
+};
+
+// 读侧临界区, 可以嵌套
+class Guard {
+  public:
+    Guard() noexcept : m_state(ThreadState::local()) { m_state.pin(); }
+    ~Guard() { m_state.unpin(); }
+    Guard(Guard const&) = delete;
+    Guard& operator=(Guard const&) = delete;
+
+  private:
+    ThreadState& m_state;
+};
+
+// 对象已经从共享结构上摘下后调用, 攒够一批再统一释放
+inline void retire(void* p, void (*deleter)(void*)) {
+    ThreadState& s = ThreadState::local();
+    // 调用方摘下对象的写必须先于读epoch, 否则弱内存序下可能打上比
+    // 并发读者看到它时更旧的epoch
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    s.m_retired.push_back(Retired{
+        p, deleter,
+        Domain::instance().m_epoch.load(std::memory_order_relaxed)});
+    if (s.m_retired.size() >= kCollectThreshold)
+        s.collect();
+}
+
+template <typename T, typename Deleter = DefaultDeleter<T>>
+void retire(T* p) {
+    retire(p, &detail::retiredDelete<T, Deleter>);
+}
+
+inline void collect() { ThreadState::local().collect(); }
+
+// 阻塞直到本线程退休的所有对象都被释放; 调用线程不能持有Guard
+inline void synchronize() {
+    ThreadState& s = ThreadState::local();
+    while (true) {
+        s.collect();
+        if (s.m_retired.empty())
+            return;
+        std::this_thread::yield();
+    }
+}
+} // namespace ebr
+
+namespace hazard {
+inline constexpr std::size_t kScanThreshold = 64;
+
+struct alignas(64) Slot {
+    std::atomic<void const*> m_ptr{nullptr};
+    std::atomic<bool> m_inUse{true};
+    Slot* m_next = nullptr;
+};
+
+struct Domain {
+    alignas(64) std::atomic<Slot*> m_head{nullptr};
+    std::atomic<std::size_t> m_slots{0};
+    detail::OrphanList m_orphans;
+
+    static Domain& instance() {
+        static Domain s_domain;
+        return s_domain;
+    }
+
+    Slot* acquireSlot() {
+        for (Slot* s = m_head.load(std::memory_order_acquire); s;
+             s = s->m_next) {
+            bool expected = false;
+            if (!s->m_inUse.load(std::memory_order_relaxed) &&
+                s->m_inUse.compare_exchange_strong(expected, true))
+                return s;
+        }
+        auto* s = new Slot;
+        s->m_next = m_head.load(std::memory_order_relaxed);
+        while (!m_head.compare_exchange_weak(s->m_next, s,
+                                             std::memory_order_release,
+                                             std::memory_order_relaxed)) {
+        }
+        m_slots.fetch_add(1, std::memory_order_relaxed);
+        return s;
+    }
+};
+
+// 一个hazard pointer槽位, protect之后指向的对象不会被释放
+class HazardPointer {
+  public:
+    HazardPointer() : m_slot(Domain::instance().acquireSlot()) {}
+    ~HazardPointer() {
+        m_slot->m_ptr.store(nullptr, std::memory_order_release);
+        m_slot->m_inUse.store(false, std::memory_order_release);
+    }
+    HazardPointer(HazardPointer const&) = delete;
+    HazardPointer& operator=(HazardPointer const&) = delete;
+
+    // 发布后重新读一次src, 两次一致才说明发布时对象还没被摘下
+    template <typename T> T* protect(std::atomic<T*> const& src) noexcept {
+        T* p = src.load(std::memory_order_relaxed);
+        while (true) {
+            m_slot->m_ptr.store(p, std::memory_order_seq_cst);
+            T* q = src.load(std::memory_order_acquire);
+            if (q == p)
+                return p;
+            p = q;
+        }
+    }
+
+    void reset() noexcept {
+        m_slot->m_ptr.store(nullptr, std::memory_order_release);
+    }
+
+  private:
+    Slot* m_slot;
+};
+
+struct ThreadState {
+    bool m_scanning = false;
+    Vector<Retired> m_retired;
+
+    ~ThreadState() {
+        scan();
+        Domain::instance().m_orphans.adopt(m_retired);
+    }
+
+    static ThreadState& local() {
+        static thread_local ThreadState s_state;
+        return s_state;
+    }
+
+    // 释放所有没被任何hazard pointer指着的对象
+    // 和ebr一样先把列表换出来, deleter 里可以再retire
+    void scan() {
+        if (m_scanning)
+            return;
+        m_scanning = true;
+        Domain& d = Domain::instance();
+        Vector<Retired> batch;
+        batch.swap(m_retired);
+        d.m_orphans.takeInto(batch);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        Vector<void const*> hazards;
+        for (Slot* s = d.m_head.load(std::memory_order_acquire); s;
+             s = s->m_next) {
+            if (void const* p = s->m_ptr.load(std::memory_order_acquire))
+                hazards.push_back(p);
+        }
+        std::sort(hazards.begin(), hazards.end());
+        for (auto const& r : batch) {
+            if (std::binary_search(hazards.begin(), hazards.end(), r.m_ptr))
+                m_retired.push_back(r);
+            else
+                r.reclaim();
+        }
+        m_scanning = false;
+    }
+};
+
+// 未释放对象数量不超过 阈值 + 槽位数
+inline void retire(void* p, void (*deleter)(void*)) {
+    ThreadState& s = ThreadState::local();
+    s.m_retired.push_back(Retired{p, deleter, 0});
+    std::size_t threshold = std::max(
+        kScanThreshold,
+        2 * Domain::instance().m_slots.load(std::memory_order_relaxed));
+    if (s.m_retired.size() >= threshold)
+        s.scan();
+}
+
+template <typename T, typename Deleter = DefaultDeleter<T>>
+void retire(T* p) {
+    retire(p, &detail::retiredDelete<T, Deleter>);
+}
+
+inline void scan() { ThreadState::local().scan(); }
+} // namespace hazard
+} // namespace lstl
@@ -0,0 +1,289 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+#include "lstl/Array.hpp"
+#include "lstl/UniquePtr.hpp"
+
+namespace lstl {
+inline constexpr std::size_t kCacheLine = 64;
+
+namespace detail {
+inline void cpuRelax() noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    asm volatile("yield");
+#endif
+}
+
+// 阻塞包装用: 先自旋, 再用 atomic::wait 挂起.
+// 每次成功的入队/出队都调用notify, 平时只有一个fence加一次relaxed读;
+// 只有确实有人挂起时, notify才会去写m_epoch和唤醒
+struct alignas(kCacheLine) Parking {
+    static constexpr int kSpins = 256;
+
+    std::atomic<std::uint32_t> m_sleepers{0};
+    std::atomic<std::uint32_t> m_epoch{0};
+
+    void notify() noexcept {
+        // 与等待方的 m_sleepers.fetch_add 构成Dekker式的配对, 防止丢失唤醒
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (m_sleepers.load(std::memory_order_relaxed) != 0) {
+            m_epoch.fetch_add(1, std::memory_order_release);
+            m_epoch.notify_all();
+        }
+    }
+
+    template <typename TryOp> void wait(TryOp&& tryOp) {
+        for (int i = 0; i != kSpins; i++) {
+            if (tryOp())
+                return;
+            cpuRelax();
+        }
+        while (true) {
+            m_sleepers.fetch_add(1, std::memory_order_seq_cst);
+            // 与notify里的fence配对, 重试时一定能看到对方在fence之前的修改
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            std::uint32_t e = m_epoch.load(std::memory_order_acquire);
+            if (tryOp()) {
+                m_sleepers.fetch_sub(1, std::memory_order_relaxed);
+                return;
+            }
+            m_epoch.wait(e, std::memory_order_acquire);
+            m_sleepers.fetch_sub(1, std::memory_order_relaxed);
+        }
+    }
+};
+} // namespace detail
+
+// 单生产者单消费者环形队列, 元素存放在对象内部的Array里
+// 生产者和消费者各占一条cache line, 各自缓存对方的下标, 只有缓存显示
+// 满/空时才去读对方的原子变量
+template <typename T, std::size_t N> class SpscRing {
+    static_assert(N != 0 && (N & (N - 1)) == 0, "N must be a power of two");
+    static_assert(std::is_default_constructible_v<T>,
+                  "SpscRing stores T in an Array");
+    static constexpr std::size_t kMask = N - 1;
+
+  public:
+    using value_type = T;
+
+    static constexpr std::size_t capacity() noexcept { return N; }
+
+    bool try_push(T const& value) { return emplace(value); }
+    bool try_push(T&& value) { return emplace(std::move(value)); }
+
+    bool try_pop(T& out) {
+        std::size_t head = m_consumer.m_head.load(std::memory_order_relaxed);
+        if (head == m_consumer.m_cachedTail) {
+            m_consumer.m_cachedTail =
+                m_producer.m_tail.load(std::memory_order_acquire);
+            if (head == m_consumer.m_cachedTail)
+                return false;
+        }
+        out = std::move(m_data[head & kMask]);
+        m_consumer.m_head.store(head + 1, std::memory_order_release);
+        m_notFull.notify();
+        return true;
+    }
+
+    // 批量搬运: 一次最多分两段连续内存, 返回实际搬运的个数
+    std::size_t push_n(T const* src, std::size_t n) {
+        std::size_t tail = m_producer.m_tail.load(std::memory_order_relaxed);
+        std::size_t free = N - (tail - m_producer.m_cachedHead);
+        if (free < n) {
+            m_producer.m_cachedHead =
+                m_consumer.m_head.load(std::memory_order_acquire);
+            free = N - (tail - m_producer.m_cachedHead);
+        }
+        n = std::min(n, free);
+        if (n == 0)
+            return 0;
+        std::size_t first = std::min(n, N - (tail & kMask));
+        std::copy_n(src, first, m_data.begin() + (tail & kMask));
+        std::copy_n(src + first, n - first, m_data.begin());
+        m_producer.m_tail.store(tail + n, std::memory_order_release);
+        m_notEmpty.notify();
+        return n;
+    }
+
+    std::size_t pop_n(T* dst, std::size_t n) {
+        std::size_t head = m_consumer.m_head.load(std::memory_order_relaxed);
+        std::size_t avail = m_consumer.m_cachedTail - head;
+        if (avail < n) {
+            m_consumer.m_cachedTail =
+                m_producer.m_tail.load(std::memory_order_acquire);
+            avail = m_consumer.m_cachedTail - head;
+        }
+        n = std::min(n, avail);
+        if (n == 0)
+            return 0;
+        std::size_t first = std::min(n, N - (head & kMask));
+        auto it = m_data.begin() + (head & kMask);
+        std::move(it, it + first, dst);
+        std::move(m_data.begin(), m_data.begin() + (n - first), dst + first);
+        m_consumer.m_head.store(head + n, std::memory_order_release);
+        m_notFull.notify();
+        return n;
+    }
+
+    // 阻塞版本: 先自旋, 再挂起
+    void push(T value) {
+        m_notFull.wait([&] { return try_push(std::move(value)); });
+    }
+    T pop() {
+        T out;
+        m_notEmpty.wait([&] { return try_pop(out); });
+        return out;
+    }
+
+    // 只是近似值, 调用时对方可能正在修改
+    std::size_t size() const noexcept {
+        return m_producer.m_tail.load(std::memory_order_acquire) -
+               m_consumer.m_head.load(std::memory_order_acquire);
+    }
+    bool empty() const noexcept { return size() == 0; }
+
+  private:
+    template <typename U> bool emplace(U&& value) {
+        std::size_t tail = m_producer.m_tail.load(std::memory_order_relaxed);
+        if (tail - m_producer.m_cachedHead == N) {
+            m_producer.m_cachedHead =
+                m_consumer.m_head.load(std::memory_order_acquire);
+            if (tail - m_producer.m_cachedHead == N)
+                return false;
+        }
+        m_data[tail & kMask] = std::forward<U>(value);
+        m_producer.m_tail.store(tail + 1, std::memory_order_release);
+        m_notEmpty.notify();
+        return true;
+    }
+
+    struct alignas(kCacheLine) Producer {
+        std::atomic<std::size_t> m_tail{0};
+        std::size_t m_cachedHead = 0;
+    };
+    struct alignas(kCacheLine) Consumer {
+        std::atomic<std::size_t> m_head{0};
+        std::size_t m_cachedTail = 0;
+    };
+
+    Producer m_producer;
+    Consumer m_consumer;
+    detail::Parking m_notEmpty;
+    detail::Parking m_notFull;
+    alignas(kCacheLine) Array<T, N> m_data{};
+};
+
+// 有界多生产者多消费者队列(Vyukov), 每个槽位带一个序号,
+// 生产者/消费者用CAS抢下标, 用槽位序号判断满/空
+template <typename T> class MpmcRing {
+    struct alignas(kCacheLine) Cell {
+        std::atomic<std::size_t> m_seq;
+        T m_value;
+    };
+
+  public:
+    using value_type = T;
+
+    // 容量向上取整到2的幂
+    explicit MpmcRing(std::size_t capacity)
+        : m_capacity(std::bit_ceil(std::max<std::size_t>(capacity, 2))),
+          m_mask(m_capacity - 1), m_cells(makeUnique<Cell[]>(m_capacity)) {
+        for (std::size_t i = 0; i != m_capacity; i++)
+            m_cells[i].m_seq.store(i, std::memory_order_relaxed);
+    }
+
+    MpmcRing(MpmcRing const&) = delete;
+    MpmcRing& operator=(MpmcRing const&) = delete;
+
+    std::size_t capacity() const noexcept { return m_capacity; }
+
+    bool try_push(T const& value) { return emplace(value); }
+    bool try_push(T&& value) { return emplace(std::move(value)); }
+
+    bool try_pop(T& out) {
+        std::size_t pos = m_head.load(std::memory_order_relaxed);
+        while (true) {
+            Cell& cell = m_cells[pos & m_mask];
+            std::size_t seq = cell.m_seq.load(std::memory_order_acquire);
+            auto diff = static_cast<std::ptrdiff_t>(seq - (pos + 1));
+            if (diff == 0) {
+                if (m_head.compare_exchange_weak(pos, pos + 1,
+                                                 std::memory_order_relaxed)) {
+                    out = std::move(cell.m_value);
+                    cell.m_seq.store(pos + m_capacity,
+                                     std::memory_order_release);
+                    m_notFull.notify();
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = m_head.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // 多生产者时槽位不保证连续, 批量接口逐个搬运, 返回实际搬运的个数
+    std::size_t push_n(T const* src, std::size_t n) {
+        std::size_t i = 0;
+        while (i != n && try_push(src[i]))
+            i++;
+        return i;
+    }
+    std::size_t pop_n(T* dst, std::size_t n) {
+        std::size_t i = 0;
+        while (i != n && try_pop(dst[i]))
+            i++;
+        return i;
+    }
+
+    // 阻塞版本: 先自旋, 再挂起
+    void push(T value) {
+        m_notFull.wait([&] { return try_push(std::move(value)); });
+    }
+    T pop() {
+        T out;
+        m_notEmpty.wait([&] { return try_pop(out); });
+        return out;
+    }
+
+  private:
+    template <typename U> bool emplace(U&& value) {
+        std::size_t pos = m_tail.load(std::memory_order_relaxed);
+        while (true) {
+            Cell& cell = m_cells[pos & m_mask];
+            std::size_t seq = cell.m_seq.load(std::memory_order_acquire);
+            auto diff = static_cast<std::ptrdiff_t>(seq - pos);
+            if (diff == 0) {
+                if (m_tail.compare_exchange_weak(pos, pos + 1,
+                                                 std::memory_order_relaxed)) {
+                    cell.m_value = std::forward<U>(value);
+                    cell.m_seq.store(pos + 1, std::memory_order_release);
+                    m_notEmpty.notify();
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = m_tail.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    std::size_t m_capacity;
+    std::size_t m_mask;
+    UniquePtr<Cell[]> m_cells;
+    alignas(kCacheLine) std::atomic<std::size_t> m_tail{0};
+    alignas(kCacheLine) std::atomic<std::size_t> m_head{0};
+    detail::Parking m_notEmpty;
+    detail::Parking m_notFull;
+};
+} // namespace lstl
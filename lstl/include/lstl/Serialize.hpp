@@ -0,0 +1,551 @@
+#pragma once
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "lstl/Array.hpp"
+#include "lstl/Deque.hpp"
+#include "lstl/Map.hpp"
+#include "lstl/Vector.hpp"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <cerrno>
+#include <climits>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#define LSTL_HAS_POSIX_IO 1
+#endif
+
+#if defined(__has_builtin)
+#if __has_builtin(__builtin_clear_padding)
+#define LSTL_HAS_CLEAR_PADDING 1
+#endif
+#endif
+
+namespace lstl {
+// 容器的二进制序列化
+//
+// 每个容器写成一个blob: 64字节的header + payload, payload补齐到8字节.
+// 元素平凡可复制时payload就是连续内存本身, 写出时不拷贝(可能带填充字节的
+// 类型除外, 要先拷贝一份把填充清零), 和header一起
+// 作为iovec交给writev; 读的时候可以直接在buffer或mmap上建view, 不用反序列化.
+// 元素本身是容器时, payload是依次排列的子blob.
+// 只支持小端机器, 不做字节序转换.
+static_assert(std::endian::native == std::endian::little,
+              "lstl blobs are little-endian only");
+
+struct SerializeError : std::runtime_error {
+    using std::runtime_error::runtime_error;
+};
+
+enum class BlobKind : std::uint8_t {
+    Pod = 1,        // 平凡可复制元素的连续数组
+    Seq = 2,        // 子blob序列
+    SortedKeys = 3, // 有序的键, Set 使用
+};
+
+struct BlobHeader {
+    static constexpr std::uint32_t kMagic = 0x4c54534c; // "LSTL"
+    static constexpr std::uint16_t kVersion = 1;
+
+    std::uint32_t magic;
+    std::uint16_t version;
+    BlobKind kind;
+    std::uint8_t reserved0;
+    std::uint32_t elemSize; // Pod/SortedKeys 的元素大小, Seq 为0
+    std::uint32_t reserved1;
+    std::uint64_t count;        // 元素个数
+    std::uint64_t payloadBytes; // 不含header, 已经补齐到8字节
+    std::uint64_t checksum;     // payload的校验和
+    std::uint8_t reserved2[24];
+};
+static_assert(sizeof(BlobHeader) == 64);
+static_assert(std::is_trivially_copyable_v<BlobHeader>);
+
+namespace detail {
+inline constexpr std::size_t kBlobAlign = 8;
+
+inline std::size_t padTo8(std::size_t n) noexcept {
+    return (n + kBlobAlign - 1) & ~(kBlobAlign - 1);
+}
+
+// 按8字节字处理的校验和, n 必须是8的倍数
+inline std::uint64_t checksumUpdate(std::uint64_t h, void const* data,
+                                    std::size_t n) noexcept {
+    auto const* p = static_cast<unsigned char const*>(data);
+    for (std::size_t i = 0; i != n; i += 8) {
+        std::uint64_t w;
+        std::memcpy(&w, p + i, 8);
+        h = std::rotl(h ^ (w * 0x87c37b91114253d5ull), 31) *
+            0x4cf5ad432745937full;
+    }
+    return h;
+}
+inline constexpr std::uint64_t kChecksumSeed = 0x9e3779b97f4a7c15ull;
+
+// 分段累加, 段长度任意, 不足一个字的部分留到下一段
+class Checksum {
+  public:
+    void update(void const* data, std::size_t n) noexcept {
+        auto const* p = static_cast<unsigned char const*>(data);
+        if (m_carry) {
+            std::size_t take = std::min(n, kBlobAlign - m_carry);
+            std::memcpy(m_buf + m_carry, p, take);
+            m_carry += take;
+            p += take;
+            n -= take;
+            if (m_carry != kBlobAlign)
+                return;
+            m_hash = checksumUpdate(m_hash, m_buf, kBlobAlign);
+            m_carry = 0;
+        }
+        std::size_t whole = n & ~(kBlobAlign - 1);
+        m_hash = checksumUpdate(m_hash, p, whole);
+        m_carry = n - whole;
+        std::memcpy(m_buf, p + whole, m_carry);
+    }
+    // 总长度是8的倍数, 不会有剩余
+    std::uint64_t value() const noexcept { return m_hash; }
+
+  private:
+    std::uint64_t m_hash = kChecksumSeed;
+    unsigned char m_buf[kBlobAlign] = {};
+    std::size_t m_carry = 0;
+};
+
+inline unsigned char const kZeros[kBlobAlign] = {};
+
+// 没有唯一对象表示的类型可能带填充字节, 直接写出时blob的内容不确定.
+// float/double 每一位都属于值; long double 在x86-64上是16字节里的10字节,
+// 不能豁免
+template <typename T>
+inline constexpr bool kMayHavePadding =
+    !std::has_unique_object_representations_v<T> &&
+    !std::is_same_v<T, float> && !std::is_same_v<T, double>;
+} // namespace detail
+
+// 收集要写出的内存段, 平凡可复制的数据只记指针不拷贝
+// 被序列化的容器在写出之前不能修改或销毁
+class BlobWriter {
+  public:
+    struct Segment {
+        void const* data;
+        std::size_t len;
+    };
+
+    void writePod(BlobKind kind, void const* data, std::size_t elemSize,
+                  std::size_t count) {
+        std::size_t bytes = elemSize * count;
+        std::size_t padded = detail::padTo8(bytes);
+        BlobHeader& h = newHeader(kind, elemSize, count);
+        h.payloadBytes = padded;
+        addSegment(&h, sizeof(BlobHeader));
+        detail::Checksum sum;
+        if (bytes) {
+            addSegment(data, bytes);
+            sum.update(data, bytes);
+        }
+        if (padded != bytes) {
+            addSegment(detail::kZeros, padded - bytes);
+            sum.update(detail::kZeros, padded - bytes);
+        }
+        h.checksum = sum.value();
+    }
+
+    // 不在原地的数据(比如树的中序遍历结果)先拷贝到writer自己持有的buffer里
+    template <typename T>
+    void writeOwnedPod(BlobKind kind, Vector<T> const& data) {
+        static_assert(std::is_trivially_copyable_v<T>);
+        Vector<std::byte>& bytes = m_owned.emplace_back();
+        bytes.resize(data.size() * sizeof(T));
+        if (data.size())
+            std::memcpy(bytes.data(), data.data(), bytes.size());
+        writePod(kind, bytes.data(), sizeof(T), data.size());
+    }
+
+    // 平凡可复制元素的数组; 可能带填充时拷贝一份并把填充清零, 否则原地写出
+    template <typename T>
+    void writeElements(BlobKind kind, T const* data, std::size_t count) {
+        static_assert(std::is_trivially_copyable_v<T>);
+        if constexpr (detail::kMayHavePadding<T>) {
+#ifdef LSTL_HAS_CLEAR_PADDING
+            Vector<std::byte>& bytes = m_owned.emplace_back();
+            bytes.resize(count * sizeof(T));
+            for (std::size_t i = 0; i != count; i++) {
+                T elem = data[i];
+                __builtin_clear_padding(&elem);
+                std::memcpy(bytes.data() + i * sizeof(T), &elem, sizeof(T));
+            }
+            writePod(kind, bytes.data(), sizeof(T), count);
+#else
+            static_assert(!detail::kMayHavePadding<T>,
+                          "element type may contain padding bytes");
+#endif
+        } else {
+            writePod(kind, data, sizeof(T), count);
+        }
+    }
+
+    // 子blob写完后调用endSeq回填payload大小和校验和
+    std::size_t beginSeq(std::size_t count) {
+        newHeader(BlobKind::Seq, 0, count);
+        addSegment(&m_headers.back(), sizeof(BlobHeader));
+        return m_segments.size();
+    }
+    void endSeq(std::size_t mark) {
+        BlobHeader& h = *static_cast<BlobHeader*>(
+            const_cast<void*>(m_segments[mark - 1].data));
+        detail::Checksum sum;
+        std::size_t bytes = 0;
+        for (std::size_t i = mark; i != m_segments.size(); i++) {
+            bytes += m_segments[i].len;
+            sum.update(m_segments[i].data, m_segments[i].len);
+        }
+        h.payloadBytes = bytes;
+        h.checksum = sum.value();
+    }
+
+    std::size_t size() const noexcept { return m_bytes; }
+    Vector<Segment> const& segments() const noexcept { return m_segments; }
+
+    // 拼成一整块, 用于写到socket或者内存里的buffer
+    Vector<std::byte> toBytes() const {
+        Vector<std::byte> out;
+        out.resize(m_bytes);
+        std::size_t pos = 0;
+        for (auto const& s : m_segments) {
+            if (s.len)
+                std::memcpy(out.data() + pos, s.data, s.len);
+            pos += s.len;
+        }
+        return out;
+    }
+
+#ifdef LSTL_HAS_POSIX_IO
+    // scatter/gather写, 每批最多IOV_MAX段
+    void writeTo(int fd) const {
+        Vector<iovec> iov;
+        for (auto const& s : m_segments)
+            iov.push_back(iovec{const_cast<void*>(s.data), s.len});
+        std::size_t first = 0;
+        while (first != iov.size()) {
+            int n = static_cast<int>(std::min<std::size_t>(
+                iov.size() - first, static_cast<std::size_t>(IOV_MAX)));
+            ssize_t written = ::writev(fd, iov.data() + first, n);
+            if (written < 0) {
+                if (errno == EINTR)
+                    continue;
+                throw SerializeError("writev failed");
+            }
+            // 处理部分写
+            auto left = static_cast<std::size_t>(written);
+            while (first != iov.size() && left >= iov[first].iov_len) {
+                left -= iov[first].iov_len;
+                first++;
+            }
+            if (left) {
+                iov[first].iov_base = static_cast<char*>(iov[first].iov_base) +
+                                      left;
+                iov[first].iov_len -= left;
+            }
+        }
+    }
+#endif
+
+  private:
+    BlobHeader& newHeader(BlobKind kind, std::size_t elemSize,
+                          std::size_t count) {
+        BlobHeader h{};
+        h.magic = BlobHeader::kMagic;
+        h.version = BlobHeader::kVersion;
+        h.kind = kind;
+        h.elemSize = static_cast<std::uint32_t>(elemSize);
+        h.count = count;
+        // Deque 保证之前记下的header地址不变
+        m_headers.push_back(h);
+        return m_headers.back();
+    }
+
+    void addSegment(void const* data, std::size_t len) {
+        m_segments.push_back(Segment{data, len});
+        m_bytes += len;
+    }
+
+    Deque<BlobHeader> m_headers;
+    Deque<Vector<std::byte>> m_owned;
+    Vector<Segment> m_segments;
+    std::size_t m_bytes = 0;
+};
+
+// 顺序读取blob, 并校验header
+class BlobReader {
+  public:
+    explicit BlobReader(std::span<std::byte const> bytes) noexcept
+        : m_bytes(bytes) {}
+
+    bool done() const noexcept { return m_pos == m_bytes.size(); }
+
+    // 读出下一个blob的header, 返回其payload
+    std::span<std::byte const> next(BlobHeader& h, BlobKind kind,
+                                    std::size_t elemSize,
+                                    bool verifyChecksum = true) {
+        if (m_bytes.size() - m_pos < sizeof(BlobHeader))
+            throw SerializeError("truncated blob header");
+        std::memcpy(&h, m_bytes.data() + m_pos, sizeof(BlobHeader));
+        if (h.magic != BlobHeader::kMagic)
+            throw SerializeError("bad blob magic");
+        if (h.version != BlobHeader::kVersion)
+            throw SerializeError("unsupported blob version");
+        if (h.kind != kind || h.elemSize != elemSize)
+            throw SerializeError("blob type mismatch");
+        m_pos += sizeof(BlobHeader);
+        if (m_bytes.size() - m_pos < h.payloadBytes ||
+            h.payloadBytes % detail::kBlobAlign != 0 ||
+            h.count > h.payloadBytes / (elemSize ? elemSize
+                                                 : sizeof(BlobHeader)))
+            throw SerializeError("truncated blob payload");
+        auto payload = m_bytes.subspan(m_pos, h.payloadBytes);
+        if (verifyChecksum &&
+            detail::checksumUpdate(detail::kChecksumSeed, payload.data(),
+                                   payload.size()) != h.checksum)
+            throw SerializeError("blob checksum mismatch");
+        m_pos += h.payloadBytes;
+        return payload;
+    }
+
+  private:
+    std::span<std::byte const> m_bytes;
+    std::size_t m_pos = 0;
+};
+
+// serialize / deserialize
+
+template <typename T>
+concept Serializable = requires(BlobWriter& w, T const& value) {
+    serialize(w, value);
+};
+
+template <typename T, typename Alloc>
+void serialize(BlobWriter& w, Vector<T, Alloc> const& v) {
+    if constexpr (std::is_trivially_copyable_v<T>) {
+        w.writeElements(BlobKind::Pod, v.data(), v.size());
+    } else {
+        std::size_t mark = w.beginSeq(v.size());
+        for (auto const& elem : v)
+            serialize(w, elem);
+        w.endSeq(mark);
+    }
+}
+
+template <typename T, std::size_t N>
+void serialize(BlobWriter& w, Array<T, N> const& a) {
+    if constexpr (std::is_trivially_copyable_v<T>) {
+        w.writeElements(BlobKind::Pod, a.data(), N);
+    } else {
+        std::size_t mark = w.beginSeq(N);
+        for (auto const& elem : a)
+            serialize(w, elem);
+        w.endSeq(mark);
+    }
+}
+
+// 中序遍历得到有序的键, 读的时候可以直接二分查找
+inline void serialize(BlobWriter& w, Set const& set) {
+    Vector<int> keys;
+    Vector<Node const*> stack;
+    Node const* cur = set.root;
+    while (cur || !stack.empty()) {
+        while (cur) {
+            stack.push_back(cur);
+            cur = cur->left;
+        }
+        cur = stack.back();
+        stack.pop_back();
+        keys.push_back(cur->value);
+        cur = cur->right;
+    }
+    w.writeOwnedPod(BlobKind::SortedKeys, keys);
+}
+
+template <typename T, typename Alloc>
+void deserialize(BlobReader& r, Vector<T, Alloc>& out) {
+    BlobHeader h;
+    out.clear();
+    if constexpr (std::is_trivially_copyable_v<T>) {
+        auto payload = r.next(h, BlobKind::Pod, sizeof(T));
+        out.resize(h.count);
+        if (h.count)
+            std::memcpy(static_cast<void*>(out.data()), payload.data(),
+                        h.count * sizeof(T));
+    } else {
+        BlobReader inner(r.next(h, BlobKind::Seq, 0));
+        out.reserve(h.count);
+        for (std::uint64_t i = 0; i != h.count; i++) {
+            T elem;
+            deserialize(inner, elem);
+            out.push_back(std::move(elem));
+        }
+    }
+}
+
+template <typename T, std::size_t N>
+void deserialize(BlobReader& r, Array<T, N>& out) {
+    BlobHeader h;
+    if constexpr (std::is_trivially_copyable_v<T>) {
+        auto payload = r.next(h, BlobKind::Pod, sizeof(T));
+        if (h.count != N)
+            throw SerializeError("array length mismatch");
+        std::memcpy(static_cast<void*>(out.data()), payload.data(),
+                    N * sizeof(T));
+    } else {
+        BlobReader inner(r.next(h, BlobKind::Seq, 0));
+        if (h.count != N)
+            throw SerializeError("array length mismatch");
+        for (auto& elem : out)
+            deserialize(inner, elem);
+    }
+}
+
+// 键已经有序, 直接建平衡树, 不逐个insert
+inline void deserialize(BlobReader& r, Set& out) {
+    BlobHeader h;
+    auto payload = r.next(h, BlobKind::SortedKeys, sizeof(int));
+    Vector<int> keys;
+    keys.resize(h.count);
+    if (h.count)
+        std::memcpy(keys.data(), payload.data(), h.count * sizeof(int));
+    for (std::size_t i = 1; i < keys.size(); i++) {
+        if (!(keys[i - 1] < keys[i]))
+            throw SerializeError("set keys not sorted");
+    }
+    out.assign_sorted(keys.data(), keys.size());
+}
+
+// 整块序列化/反序列化的便捷接口
+template <Serializable T> Vector<std::byte> toBytes(T const& value) {
+    BlobWriter w;
+    serialize(w, value);
+    return w.toBytes();
+}
+
+template <typename T> void fromBytes(std::span<std::byte const> bytes, T& out) {
+    BlobReader r(bytes);
+    deserialize(r, out);
+}
+
+// views: 直接在序列化结果上只读访问, 不拷贝
+
+// Vector/Array(平凡可复制元素)的只读视图
+template <typename T> class VectorView {
+    static_assert(std::is_trivially_copyable_v<T>);
+
+  public:
+    using value_type = T;
+    using const_iterator = T const*;
+
+    explicit VectorView(std::span<std::byte const> blob,
+                        bool verifyChecksum = true) {
+        BlobReader r(blob);
+        BlobHeader h;
+        auto payload = r.next(h, BlobKind::Pod, sizeof(T), verifyChecksum);
+        if (reinterpret_cast<std::uintptr_t>(payload.data()) % alignof(T))
+            throw SerializeError("blob payload misaligned for T");
+        m_data = reinterpret_cast<T const*>(payload.data());
+        m_size = h.count;
+    }
+
+    T const* data() const noexcept { return m_data; }
+    std::size_t size() const noexcept { return m_size; }
+    bool empty() const noexcept { return m_size == 0; }
+    T const& operator[](std::size_t i) const noexcept { return m_data[i]; }
+    const_iterator begin() const noexcept { return m_data; }
+    const_iterator end() const noexcept { return m_data + m_size; }
+    std::span<T const> span() const noexcept { return {m_data, m_size}; }
+
+  private:
+    T const* m_data = nullptr;
+    std::size_t m_size = 0;
+};
+
+// Set的只读视图, 键有序, 查找是二分
+class SetView {
+  public:
+    explicit SetView(std::span<std::byte const> blob,
+                     bool verifyChecksum = true) {
+        BlobReader r(blob);
+        BlobHeader h;
+        auto payload =
+            r.next(h, BlobKind::SortedKeys, sizeof(int), verifyChecksum);
+        if (reinterpret_cast<std::uintptr_t>(payload.data()) % alignof(int))
+            throw SerializeError("blob payload misaligned for int");
+        m_keys = reinterpret_cast<int const*>(payload.data());
+        m_size = h.count;
+    }
+
+    std::size_t size() const noexcept { return m_size; }
+    int const* begin() const noexcept { return m_keys; }
+    int const* end() const noexcept { return m_keys + m_size; }
+    bool contains(int key) const noexcept {
+        return std::binary_search(begin(), end(), key);
+    }
+    int const* lower_bound(int key) const noexcept {
+        return std::lower_bound(begin(), end(), key);
+    }
+
+  private:
+    int const* m_keys = nullptr;
+    std::size_t m_size = 0;
+};
+
+#ifdef LSTL_HAS_POSIX_IO
+// 只读mmap一个文件, 配合view使用; 映射起始地址按页对齐
+class MappedFile {
+  public:
+    explicit MappedFile(char const* path) {
+        int fd = ::open(path, O_RDONLY);
+        if (fd < 0)
+            throw SerializeError("open failed");
+        struct stat st;
+        if (::fstat(fd, &st) != 0) {
+            ::close(fd);
+            throw SerializeError("fstat failed");
+        }
+        m_size = static_cast<std::size_t>(st.st_size);
+        if (m_size) {
+            void* p = ::mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (p == MAP_FAILED) {
+                ::close(fd);
+                throw SerializeError("mmap failed");
+            }
+            m_data = static_cast<std::byte const*>(p);
+        }
+        ::close(fd);
+    }
+
+    MappedFile(MappedFile const&) = delete;
+    MappedFile& operator=(MappedFile const&) = delete;
+
+    ~MappedFile() {
+        if (m_data)
+            ::munmap(const_cast<std::byte*>(m_data), m_size);
+    }
+
+    std::span<std::byte const> bytes() const noexcept {
+        return {m_data, m_size};
+    }
+
+  private:
+    std::byte const* m_data = nullptr;
+    std::size_t m_size = 0;
+};
+#endif
+} // namespace lstl
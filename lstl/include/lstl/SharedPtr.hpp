@@ -1,39 +1,83 @@
 #pragma once
 #include <atomic>
+#include <cstddef>
 #include <utility>
 namespace lstl {
 template <typename T> struct SpControlBlock {
     T* m_data;
-    std::atomic<int> m_refcnt;
+    std::atomic<long> m_refcnt;
 
     explicit SpControlBlock(T* ptr) : m_data(ptr), m_refcnt(1) {}
     SpControlBlock(SpControlBlock&&) = delete;
-    void incref() { m_refcnt.fetch_add(1); }
-    void decref() {
-        if (m_refcnt.fetch_sub(1) == 1)
+    ~SpControlBlock() { delete m_data; }
+    void incref(long n = 1) noexcept {
+        m_refcnt.fetch_add(n, std::memory_order_relaxed);
+    }
+    void decref() noexcept {
+        // acq_rel: 最后一个持有者必须看到其他线程对对象的所有写
+        if (m_refcnt.fetch_sub(1, std::memory_order_acq_rel) == 1)
             delete this;
     }
 };
+
+template <typename T> class AtomicSharedPtr;
+
 template <typename T> struct SharedPtr {
+    using element_type = T;
+
     SpControlBlock<T>* m_pcb;
-    explicit SharedPtr(T* ptr) : m_pcb(ptr) {}
-    SharedPtr(SharedPtr const& that) : m_pcb(that.m_pcb) {
-        m_pcb->m_refcnt++;
+
+    SharedPtr() noexcept : m_pcb(nullptr) {}
+    SharedPtr(std::nullptr_t) noexcept : m_pcb(nullptr) {}
+    explicit SharedPtr(T* ptr)
+        : m_pcb(ptr ? new SpControlBlock<T>(ptr) : nullptr) {}
+    SharedPtr(SharedPtr const& that) noexcept : m_pcb(that.m_pcb) {
+        if (m_pcb)
+            m_pcb->incref();
+    }
+    SharedPtr(SharedPtr&& that) noexcept
+        : m_pcb(std::exchange(that.m_pcb, nullptr)) {}
+
+    SharedPtr& operator=(SharedPtr const& that) noexcept {
+        SharedPtr(that).swap(*this);
+        return *this;
+    }
+    SharedPtr& operator=(SharedPtr&& that) noexcept {
+        SharedPtr(std::move(that)).swap(*this);
+        return *this;
     }
 
     ~SharedPtr() {
-        // TODO
-        if (m_pcb->m_refcnt.load() == 0) {
-            delete m_pcb;
-        }
+        if (m_pcb)
+            m_pcb->decref();
     }
 
-    T* get() const noexcept { return m_pcb->m_data; }
+    void reset() noexcept { SharedPtr().swap(*this); }
+    void reset(T* ptr) { SharedPtr(ptr).swap(*this); }
+    void swap(SharedPtr& that) noexcept { std::swap(m_pcb, that.m_pcb); }
+
+    T* get() const noexcept { return m_pcb ? m_pcb->m_data : nullptr; }
     T& operator*() const noexcept { return *m_pcb->m_data; }
     T* operator->() const noexcept { return m_pcb->m_data; }
+    explicit operator bool() const noexcept { return m_pcb != nullptr; }
+
+    long use_count() const noexcept {
+        return m_pcb ? m_pcb->m_refcnt.load(std::memory_order_relaxed) : 0;
+    }
+
+    bool operator==(SharedPtr const& that) const noexcept {
+        return m_pcb == that.m_pcb;
+    }
+
+  private:
+    // 接管一个已经计过数的控制块, 不再incref
+    struct AdoptTag {};
+    SharedPtr(SpControlBlock<T>* pcb, AdoptTag) noexcept : m_pcb(pcb) {}
+
+    friend class AtomicSharedPtr<T>;
 };
 
-template <typename T, class... Args> auto makeShared(Args... args) {
-    return SharedPtr<T>(new T(std::forward<T>(args)...));
+template <typename T, class... Args> auto makeShared(Args&&... args) {
+    return SharedPtr<T>(new T(std::forward<Args>(args)...));
 }
 } // namespace lstl
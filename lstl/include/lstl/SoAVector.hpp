@@ -0,0 +1,264 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <span>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "lstl/TypeTraits.hpp"
+
+namespace lstl {
+template <typename R>
+concept TupleLike =
+    requires { std::tuple_size<std::remove_cvref_t<R>>::value; };
+
+// 结构体数组转成数组结构体: 每个字段一列, 各自连续存放并按cache line对齐,
+// 所有列共用一个size和capacity. 只扫一个字段时不会把整行拉进cache,
+// column<I>() 返回的span可以直接交给SIMD kernel
+template <typename... Fields> class SoAVector {
+    static_assert(sizeof...(Fields) > 0, "SoAVector needs at least one field");
+
+  public:
+    static constexpr std::size_t kColumnAlign = 64;
+    static constexpr std::size_t kColumns = sizeof...(Fields);
+
+    template <std::size_t I>
+    using field_type = std::tuple_element_t<I, std::tuple<Fields...>>;
+    using size_type = std::size_t;
+    // 行的代理引用
+    using reference = std::tuple<Fields&...>;
+    using const_reference = std::tuple<Fields const&...>;
+    using value_type = std::tuple<Fields...>;
+
+    SoAVector() noexcept = default;
+
+    SoAVector(SoAVector const& that) {
+        reserve(that.m_size);
+        for (size_type i = 0; i != that.m_size; i++)
+            push_back(that[i]);
+    }
+
+    SoAVector(SoAVector&& that) noexcept
+        : m_columns(std::exchange(that.m_columns, {})),
+          m_size(std::exchange(that.m_size, 0)),
+          m_capacity(std::exchange(that.m_capacity, 0)) {}
+
+    SoAVector& operator=(SoAVector that) noexcept {
+        swap(that);
+        return *this;
+    }
+
+    ~SoAVector() {
+        clear();
+        std::apply([](auto*... cols) { (freeColumn(cols), ...); }, m_columns);
+    }
+
+    void swap(SoAVector& that) noexcept {
+        std::swap(m_columns, that.m_columns);
+        std::swap(m_size, that.m_size);
+        std::swap(m_capacity, that.m_capacity);
+    }
+
+    // about size
+
+    bool empty() const noexcept { return m_size == 0; }
+    size_type size() const noexcept { return m_size; }
+    size_type capacity() const noexcept { return m_capacity; }
+
+    void reserve(size_type n) {
+        if (n <= m_capacity)
+            return;
+        n = std::max(n, m_capacity * 2);
+        reallocate(n, std::index_sequence_for<Fields...>{});
+        m_capacity = n;
+    }
+
+    // modifier
+
+    void push_back(Fields const&... values) { emplace_back(values...); }
+
+    // 接受 std::tuple/std::pair 或者实现了tuple协议(get/tuple_size)的结构体,
+    // 结构体的get通过ADL查找
+    template <TupleLike Row>
+        requires(std::tuple_size_v<std::remove_cvref_t<Row>> == kColumns)
+    void push_back(Row&& row) {
+        pushRow(std::index_sequence_for<Fields...>{}, std::forward<Row>(row));
+    }
+
+    // 每个参数构造对应的一列
+    template <typename... Args>
+        requires(sizeof...(Args) == kColumns)
+    reference emplace_back(Args&&... args) {
+        if (m_size == m_capacity) [[unlikely]] {
+            // 参数可能引用自身的元素(比如 v.push_back(v[0])),
+            // 扩容会释放旧的列, 先把这一行构造到临时对象里
+            value_type row(std::forward<Args>(args)...);
+            reserve(m_size + 1);
+            constructRow(std::index_sequence_for<Fields...>{}, std::move(row));
+        } else {
+            constructRow(std::index_sequence_for<Fields...>{},
+                         std::forward_as_tuple(std::forward<Args>(args)...));
+        }
+        return (*this)[m_size++];
+    }
+
+    void pop_back() noexcept {
+        m_size--;
+        std::apply(
+            [this](auto*... cols) { (std::destroy_at(cols + m_size), ...); },
+            m_columns);
+    }
+
+    void clear() noexcept {
+        std::apply(
+            [this](auto*... cols) {
+                (std::destroy(cols, cols + m_size), ...);
+            },
+            m_columns);
+        m_size = 0;
+    }
+
+    // access
+
+    reference operator[](size_type i) noexcept {
+        return std::apply([i](auto*... cols) { return reference(cols[i]...); },
+                          m_columns);
+    }
+    const_reference operator[](size_type i) const noexcept {
+        return std::apply(
+            [i](auto*... cols) { return const_reference(cols[i]...); },
+            m_columns);
+    }
+
+    reference at(size_type i) {
+        if (i >= m_size) [[unlikely]]
+            throw std::out_of_range("soa_vector::at out_of_range");
+        return (*this)[i];
+    }
+    const_reference at(size_type i) const {
+        if (i >= m_size) [[unlikely]]
+            throw std::out_of_range("soa_vector::at out_of_range");
+        return (*this)[i];
+    }
+
+    template <std::size_t I> field_type<I>& get(size_type i) noexcept {
+        return std::get<I>(m_columns)[i];
+    }
+    template <std::size_t I>
+    field_type<I> const& get(size_type i) const noexcept {
+        return std::get<I>(m_columns)[i];
+    }
+
+    // 第I列, 起始地址按kColumnAlign对齐
+    template <std::size_t I> std::span<field_type<I>> column() noexcept {
+        return {std::get<I>(m_columns), m_size};
+    }
+    template <std::size_t I>
+    std::span<field_type<I> const> column() const noexcept {
+        return {std::get<I>(m_columns), m_size};
+    }
+
+  private:
+    template <typename T>
+    static constexpr std::align_val_t kAlign{
+        std::max(kColumnAlign, alignof(T))};
+
+    template <typename T> static T* allocColumn(size_type n) {
+        return static_cast<T*>(::operator new(n * sizeof(T), kAlign<T>));
+    }
+    template <typename T> static void freeColumn(T* p) noexcept {
+        if (p)
+            ::operator delete(p, kAlign<T>);
+    }
+
+    // 先分配好所有新列再逐列搬家, 全部成功后才释放旧列,
+    // 中途抛异常时释放新列, 所有列仍然共用原来的m_capacity
+    template <std::size_t... I>
+    void reallocate(size_type n, std::index_sequence<I...>) {
+        std::tuple<Fields*...> fresh{};
+        std::size_t moved = 0;
+        try {
+            ((std::get<I>(fresh) = allocColumn<field_type<I>>(n)), ...);
+            (relocateColumn<I>(std::get<I>(fresh), moved), ...);
+        } catch (...) {
+            (discardColumn<I>(std::get<I>(fresh), I < moved), ...);
+            throw;
+        }
+        (releaseColumn<I>(), ...);
+        m_columns = fresh;
+    }
+
+    // 所有列都能不抛异常地搬移时直接搬; 否则可拷贝的列都拷贝,
+    // 后面的列失败时前面的旧列仍然完好
+    static constexpr bool kNothrowRelocate =
+        ((isTriviallyRelocatable<Fields> ||
+          std::is_nothrow_move_constructible_v<Fields>) &&
+         ...);
+
+    template <std::size_t I>
+    void relocateColumn(field_type<I>* fresh, std::size_t& moved) {
+        using T = field_type<I>;
+        T* old = std::get<I>(m_columns);
+        if constexpr (isTriviallyRelocatable<T>) {
+            if (m_size)
+                std::memcpy(static_cast<void*>(fresh),
+                            static_cast<void const*>(old), m_size * sizeof(T));
+        } else if constexpr (kNothrowRelocate ||
+                             !std::is_copy_constructible_v<T>) {
+            std::uninitialized_move(old, old + m_size, fresh);
+        } else {
+            std::uninitialized_copy(old, old + m_size, fresh);
+        }
+        moved++;
+    }
+
+    // 回滚: memcpy过去的列不拥有资源, 只释放内存
+    template <std::size_t I>
+    void discardColumn(field_type<I>* fresh, bool built) noexcept {
+        if constexpr (!isTriviallyRelocatable<field_type<I>>) {
+            if (built)
+                std::destroy(fresh, fresh + m_size);
+        }
+        freeColumn(fresh);
+    }
+
+    template <std::size_t I> void releaseColumn() noexcept {
+        auto* old = std::get<I>(m_columns);
+        if constexpr (!isTriviallyRelocatable<field_type<I>>)
+            std::destroy(old, old + m_size);
+        freeColumn(old);
+    }
+
+    template <std::size_t... I, typename Row>
+    void pushRow(std::index_sequence<I...>, Row&& row) {
+        using std::get;
+        emplace_back(get<I>(std::forward<Row>(row))...);
+    }
+
+    // 在m_size处构造一行; 某列抛异常时销毁已经构造的列再抛出
+    template <std::size_t... I, typename Row>
+    void constructRow(std::index_sequence<I...>, Row&& row) {
+        std::size_t built = 0;
+        try {
+            ((std::construct_at(std::get<I>(m_columns) + m_size,
+                                std::get<I>(std::forward<Row>(row))),
+              built++),
+             ...);
+        } catch (...) {
+            ((I < built ? std::destroy_at(std::get<I>(m_columns) + m_size)
+                        : void()),
+             ...);
+            throw;
+        }
+    }
+
+    std::tuple<Fields*...> m_columns{};
+    size_type m_size = 0;
+    size_type m_capacity = 0;
+};
+} // namespace lstl
@@ -0,0 +1,286 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <barrier>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+#include "lstl/Array.hpp"
+#include "lstl/Vector.hpp"
+
+namespace lstl {
+// 算术类型的key用LSD基数排序, 每趟8位.
+// 排序是稳定的. 先一遍扫出所有位上的直方图, 某一位上所有元素都相同时跳过这一趟;
+// 元素在原数组和scratch之间来回搬, 趟数为奇数时最后搬回原数组.
+// 元素很多时分块多线程: 每趟各线程统计自己那块的直方图,
+// 合并出每个线程在每个桶里的起始位置后各自分发, 结果与单线程相同.
+//
+// 浮点数按位排序: -0.0 排在 0.0 前面, NaN 按符号排在两端.
+// 只支持1/2/4/8字节的key, 比如16字节的long double退回std::sort.
+template <typename K>
+concept RadixKey = std::is_arithmetic_v<K> &&
+                   (sizeof(K) == 1 || sizeof(K) == 2 || sizeof(K) == 4 ||
+                    sizeof(K) == 8);
+
+namespace detail {
+inline constexpr std::size_t kRadixSmall = 64;
+inline constexpr std::size_t kRadixParallel = std::size_t(1) << 20;
+// 每个线程至少分到这么多元素
+inline constexpr std::size_t kRadixPerThread = std::size_t(1) << 18;
+
+template <std::size_t Bytes> struct RadixUnsignedImpl;
+template <> struct RadixUnsignedImpl<1> { using type = std::uint8_t; };
+template <> struct RadixUnsignedImpl<2> { using type = std::uint16_t; };
+template <> struct RadixUnsignedImpl<4> { using type = std::uint32_t; };
+template <> struct RadixUnsignedImpl<8> { using type = std::uint64_t; };
+
+template <typename K>
+using RadixUnsigned = typename RadixUnsignedImpl<sizeof(K)>::type;
+
+// 映射成无符号整数, 保持大小顺序
+// 有符号数翻转符号位; 浮点数为负时全部取反, 否则只翻转符号位
+template <RadixKey K> constexpr RadixUnsigned<K> toRadix(K key) noexcept {
+    using U = RadixUnsigned<K>;
+    constexpr U kSign = U(1) << (sizeof(U) * 8 - 1);
+    if constexpr (std::is_floating_point_v<K>) {
+        U u = std::bit_cast<U>(key);
+        return static_cast<U>(u & kSign ? ~u : u | kSign);
+    } else if constexpr (std::is_signed_v<K>) {
+        return static_cast<U>(static_cast<U>(key) ^ kSign);
+    } else {
+        return static_cast<U>(key);
+    }
+}
+
+template <typename T, typename KeyFn>
+using KeyOf = std::remove_cvref_t<std::invoke_result_t<KeyFn&, T const&>>;
+template <typename T, typename KeyFn>
+using RadixOf = RadixUnsigned<KeyOf<T, KeyFn>>;
+
+template <typename U>
+constexpr std::size_t digitOf(U u, std::size_t d) noexcept {
+    return static_cast<std::size_t>(u >> (d * 8)) & 0xff;
+}
+
+using RadixHistogram = Array<std::size_t, 256>;
+
+// 小数组用插入排序, 同样是稳定的
+template <typename T, typename KeyFn>
+void insertionSortByKey(T* first, std::size_t n, KeyFn& key) {
+    for (std::size_t i = 1; i < n; i++) {
+        auto k = toRadix(std::invoke(key, first[i]));
+        if (!(k < toRadix(std::invoke(key, first[i - 1]))))
+            continue;
+        T tmp = std::move(first[i]);
+        std::size_t j = i;
+        for (; j > 0 && k < toRadix(std::invoke(key, first[j - 1])); j--)
+            first[j] = std::move(first[j - 1]);
+        first[j] = std::move(tmp);
+    }
+}
+
+// 一遍扫出所有位上的直方图
+template <typename T, typename KeyFn, std::size_t Digits>
+void radixHistograms(T const* first, std::size_t n, KeyFn& key,
+                     Array<RadixHistogram, Digits>& hist) {
+    for (std::size_t i = 0; i != n; i++) {
+        auto u = toRadix(std::invoke(key, first[i]));
+        for (std::size_t d = 0; d != Digits; d++)
+            hist[d][digitOf(u, d)]++;
+    }
+}
+
+// 需要做的趟(对应的位), 某一位上所有元素都落在同一个桶里时跳过
+template <std::size_t Digits>
+Array<std::size_t, Digits>
+radixPasses(Array<RadixHistogram, Digits> const& hist, std::size_t n,
+            std::size_t& count) {
+    Array<std::size_t, Digits> passes{};
+    count = 0;
+    for (std::size_t d = 0; d != Digits; d++) {
+        if (std::ranges::max(hist[d]) != n)
+            passes[count++] = d;
+    }
+    return passes;
+}
+
+template <typename T, typename KeyFn>
+void radixSort(T* data, T* scratch, std::size_t n, KeyFn& key) {
+    constexpr std::size_t kDigits = sizeof(RadixOf<T, KeyFn>);
+    Array<RadixHistogram, kDigits> hist{};
+    radixHistograms(data, n, key, hist);
+    std::size_t count;
+    auto passes = radixPasses(hist, n, count);
+
+    T* src = data;
+    T* dst = scratch;
+    for (std::size_t p = 0; p != count; p++) {
+        std::size_t d = passes[p];
+        RadixHistogram& offset = hist[d];
+        std::size_t sum = 0;
+        for (auto& c : offset)
+            sum += std::exchange(c, sum);
+        for (std::size_t i = 0; i != n; i++) {
+            auto u = toRadix(std::invoke(key, src[i]));
+            dst[offset[digitOf(u, d)]++] = std::move(src[i]);
+        }
+        std::swap(src, dst);
+    }
+    if (src != data)
+        std::move(src, src + n, data);
+}
+
+// 创建threads个线程运行fn(t). 全部创建成功后才放行;
+// 中途创建失败时让已经启动的线程直接退出, 返回false
+template <typename Fn> bool runWorkers(unsigned threads, Fn&& fn) {
+    enum : int { kPending, kGo, kAbort };
+    std::atomic<int> state{kPending};
+    Vector<std::jthread> workers;
+    auto entry = [&](unsigned t) {
+        state.wait(kPending, std::memory_order_acquire);
+        if (state.load(std::memory_order_acquire) == kGo)
+            fn(t);
+    };
+    try {
+        workers.reserve(threads);
+        for (unsigned t = 0; t != threads; t++)
+            workers.emplace_back(entry, t);
+    } catch (...) {
+        state.store(kAbort, std::memory_order_release);
+        state.notify_all();
+        return false;
+    }
+    state.store(kGo, std::memory_order_release);
+    state.notify_all();
+    return true;
+}
+
+// 返回false表示创建线程失败, 此时data没有被修改, 调用方退回单线程版本.
+// key 不能抛异常, 否则工作线程里会std::terminate
+template <typename T, typename KeyFn>
+bool parallelRadixSort(T* data, T* scratch, std::size_t n, KeyFn& key,
+                       unsigned threads) {
+    constexpr std::size_t kDigits = sizeof(RadixOf<T, KeyFn>);
+    auto lo = [&](unsigned t) { return n * t / threads; };
+
+    // 位上的分布与元素顺序无关, 第一遍扫描就能决定做哪几趟
+    Vector<Array<RadixHistogram, kDigits>> all;
+    all.resize(threads);
+    if (!runWorkers(threads, [&](unsigned t) {
+            radixHistograms(data + lo(t), lo(t + 1) - lo(t), key, all[t]);
+        }))
+        return false;
+    Array<RadixHistogram, kDigits> total{};
+    for (auto const& h : all)
+        for (std::size_t d = 0; d != kDigits; d++)
+            for (std::size_t b = 0; b != 256; b++)
+                total[d][b] += h[d][b];
+    std::size_t count;
+    auto passes = radixPasses(total, n, count);
+    if (count == 0)
+        return true;
+
+    T* bufs[2] = {data, scratch};
+    Vector<RadixHistogram> local;
+    local.resize(threads);
+    // 各线程统计完后由barrier的完成函数把计数转成起始位置: 先按桶, 再按线程
+    auto toOffsets = [&]() noexcept {
+        std::size_t sum = 0;
+        for (std::size_t b = 0; b != 256; b++)
+            for (unsigned t = 0; t != threads; t++)
+                sum += std::exchange(local[t][b], sum);
+    };
+    std::barrier counted(static_cast<std::ptrdiff_t>(threads), toOffsets);
+    std::barrier scattered(static_cast<std::ptrdiff_t>(threads));
+
+    auto work = [&](unsigned t) {
+        for (std::size_t p = 0; p != count; p++) {
+            std::size_t d = passes[p];
+            T* src = bufs[p & 1];
+            T* dst = bufs[(p + 1) & 1];
+            RadixHistogram& h = local[t];
+            h = RadixHistogram{};
+            for (std::size_t i = lo(t); i != lo(t + 1); i++)
+                h[digitOf(toRadix(std::invoke(key, src[i])), d)]++;
+            counted.arrive_and_wait();
+            for (std::size_t i = lo(t); i != lo(t + 1); i++) {
+                auto u = toRadix(std::invoke(key, src[i]));
+                dst[h[digitOf(u, d)]++] = std::move(src[i]);
+            }
+            scattered.arrive_and_wait();
+        }
+        if (count & 1)
+            std::move(scratch + lo(t), scratch + lo(t + 1), data + lo(t));
+    };
+    // 线程全部创建成功之前没有人会等在barrier上
+    return runWorkers(threads, work);
+}
+
+template <typename T, typename Alloc, typename KeyFn>
+void sortByRadix(Vector<T, Alloc>& v, KeyFn& key, Vector<T, Alloc>& scratch) {
+    std::size_t n = v.size();
+    if (n < kRadixSmall) {
+        insertionSortByKey(v.data(), n, key);
+        return;
+    }
+    if (scratch.size() < n)
+        scratch.resize(n);
+    auto threads = static_cast<unsigned>(
+        std::min<std::size_t>(std::max(1u, std::thread::hardware_concurrency()),
+                              n / kRadixPerThread));
+    if constexpr (std::is_nothrow_move_assignable_v<T> &&
+                  std::is_nothrow_invocable_v<KeyFn&, T const&>) {
+        if (n >= kRadixParallel && threads > 1 &&
+            parallelRadixSort(v.data(), scratch.data(), n, key, threads))
+            return;
+    }
+    radixSort(v.data(), scratch.data(), n, key);
+}
+
+struct RadixIdentity {
+    template <typename K> constexpr K operator()(K key) const noexcept {
+        return key;
+    }
+};
+} // namespace detail
+
+// 对记录按提取出的算术key做稳定排序, scratch 由调用方提供以便重复使用,
+// 不够大时会resize到v.size(), 所以T必须可默认构造.
+// key 声明为noexcept时才会多线程排序, 此时key可能被多个线程同时调用
+template <typename T, typename Alloc, typename KeyFn>
+    requires RadixKey<detail::KeyOf<T, KeyFn>> &&
+             std::default_initializable<T>
+void sort(Vector<T, Alloc>& v, KeyFn key, Vector<T, Alloc>& scratch) {
+    detail::sortByRadix(v, key, scratch);
+}
+
+template <typename T, typename Alloc, typename KeyFn>
+    requires RadixKey<detail::KeyOf<T, KeyFn>> &&
+             std::default_initializable<T>
+void sort(Vector<T, Alloc>& v, KeyFn key) {
+    Vector<T, Alloc> scratch(v.get_Allocator());
+    detail::sortByRadix(v, key, scratch);
+}
+
+template <RadixKey T, typename Alloc>
+void sort(Vector<T, Alloc>& v, Vector<T, Alloc>& scratch) {
+    detail::RadixIdentity key;
+    detail::sortByRadix(v, key, scratch);
+}
+
+// 算术类型用基数排序, 其它类型退回std::sort
+template <typename T, typename Alloc> void sort(Vector<T, Alloc>& v) {
+    if constexpr (RadixKey<T>) {
+        Vector<T, Alloc> scratch(v.get_Allocator());
+        sort(v, scratch);
+    } else {
+        std::sort(v.begin(), v.end());
+    }
+}
+} // namespace lstl
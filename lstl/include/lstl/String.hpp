@@ -0,0 +1,439 @@
+#pragma once
+#include <algorithm>
+#include <bit>
+#include <compare>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+#include "lstl/TypeTraits.hpp"
+
+namespace lstl {
+namespace detail {
+// 以8字节为单位的哈希, constexpr 可用, 所以字面量的哈希可以在编译期算好
+constexpr std::uint64_t hashMix(std::uint64_t h) noexcept {
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdull;
+    h ^= h >> 33;
+    return h;
+}
+
+constexpr std::uint64_t loadBytes(char const* p, std::size_t n) noexcept {
+    std::uint64_t w = 0;
+    if (std::is_constant_evaluated() || n != 8) {
+        for (std::size_t i = 0; i != n; i++)
+            w |= std::uint64_t(static_cast<unsigned char>(p[i])) << (i * 8);
+    } else {
+        std::memcpy(&w, p, 8);
+    }
+    return w;
+}
+
+constexpr std::uint64_t hashBytes(char const* p, std::size_t n) noexcept {
+    std::uint64_t h = 0x9e3779b97f4a7c15ull ^ (n * 0xc6a4a7935bd1e995ull);
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8)
+        h = std::rotl(h ^ hashMix(loadBytes(p + i, 8)), 27) * 5 + 0x52dce729;
+    if (i != n)
+        h ^= hashMix(loadBytes(p + i, n - i));
+    return hashMix(h);
+}
+
+// n 为0时指针可能是空的, 不能交给memcmp
+inline bool equalBytes(char const* a, char const* b, std::size_t n) noexcept {
+    return n == 0 || std::memcmp(a, b, n) == 0;
+}
+} // namespace detail
+
+// 只读的字符串视图, 和 std::string_view 可以互相转换
+// find 先用memchr找首字符再memcmp确认, 比较用memcmp, 都交给libc的向量化实现
+class StringView {
+  public:
+    using size_type = std::size_t;
+    using const_iterator = char const*;
+    static constexpr size_type npos = static_cast<size_type>(-1);
+
+    constexpr StringView() noexcept = default;
+    constexpr StringView(char const* s, size_type n) noexcept
+        : m_data(s), m_size(n) {}
+    constexpr StringView(char const* s) noexcept
+        : m_data(s), m_size(std::char_traits<char>::length(s)) {}
+    constexpr StringView(std::string_view sv) noexcept
+        : m_data(sv.data()), m_size(sv.size()) {}
+
+    constexpr operator std::string_view() const noexcept {
+        return {m_data, m_size};
+    }
+
+    constexpr char const* data() const noexcept { return m_data; }
+    constexpr size_type size() const noexcept { return m_size; }
+    constexpr bool empty() const noexcept { return m_size == 0; }
+    constexpr char operator[](size_type i) const noexcept { return m_data[i]; }
+    constexpr const_iterator begin() const noexcept { return m_data; }
+    constexpr const_iterator end() const noexcept { return m_data + m_size; }
+
+    constexpr StringView substr(size_type pos, size_type n = npos) const {
+        if (pos > m_size) [[unlikely]]
+            throw std::out_of_range("string_view::substr out_of_range");
+        return {m_data + pos, std::min(n, m_size - pos)};
+    }
+
+    size_type find(char c, size_type pos = 0) const noexcept {
+        if (pos >= m_size)
+            return npos;
+        auto const* p = static_cast<char const*>(
+            std::memchr(m_data + pos, c, m_size - pos));
+        return p ? static_cast<size_type>(p - m_data) : npos;
+    }
+
+    size_type find(StringView needle, size_type pos = 0) const noexcept {
+        size_type n = needle.m_size;
+        if (n == 0)
+            return pos <= m_size ? pos : npos;
+        if (pos >= m_size)
+            return npos;
+        char const* p = m_data + pos;
+        char const* last = m_data + m_size;
+        while (static_cast<size_type>(last - p) >= n) {
+            p = static_cast<char const*>(std::memchr(
+                p, needle.m_data[0], static_cast<size_type>(last - p) - n + 1));
+            if (!p)
+                return npos;
+            if (std::memcmp(p, needle.m_data, n) == 0)
+                return static_cast<size_type>(p - m_data);
+            ++p;
+        }
+        return npos;
+    }
+
+    bool contains(StringView needle) const noexcept {
+        return find(needle) != npos;
+    }
+    bool starts_with(StringView s) const noexcept {
+        return m_size >= s.m_size &&
+               detail::equalBytes(m_data, s.m_data, s.m_size);
+    }
+    bool ends_with(StringView s) const noexcept {
+        return m_size >= s.m_size &&
+               detail::equalBytes(m_data + m_size - s.m_size, s.m_data,
+                                  s.m_size);
+    }
+
+    int compare(StringView that) const noexcept {
+        size_type n = std::min(m_size, that.m_size);
+        if (int r = n ? std::memcmp(m_data, that.m_data, n) : 0)
+            return r;
+        return m_size < that.m_size ? -1 : m_size > that.m_size;
+    }
+
+    constexpr std::size_t hash() const noexcept {
+        return static_cast<std::size_t>(detail::hashBytes(m_data, m_size));
+    }
+
+    friend bool operator==(StringView a, StringView b) noexcept {
+        return a.m_size == b.m_size &&
+               detail::equalBytes(a.m_data, b.m_data, a.m_size);
+    }
+    friend std::strong_ordering operator<=>(StringView a,
+                                            StringView b) noexcept {
+        return a.compare(b) <=> 0;
+    }
+
+  private:
+    char const* m_data = nullptr;
+    size_type m_size = 0;
+};
+
+// 带短字符串优化的字符串, 24字节
+// 短模式: 最多23个字符直接存在对象里, 最后一个字节(m_small[23])存 23-size,
+//   size为23时它正好是0, 兼作结尾的'\0'.
+// 长模式: {指针, size, capacity}, capacity 的最高位作为长模式标记,
+//   在小端机器上就是最后一个字节的最高位, 短模式下这一位总是0.
+// 扩容和Vector一样至少翻倍, 解析大量短key时不会分配内存.
+class String {
+    static_assert(std::endian::native == std::endian::little,
+                  "String layout assumes little-endian");
+
+  public:
+    using value_type = char;
+    using size_type = std::size_t;
+    using iterator = char*;
+    using const_iterator = char const*;
+    static constexpr size_type npos = StringView::npos;
+    static constexpr size_type kSmallCapacity = 23;
+
+    String() noexcept { setSmallSize(0); }
+    String(char const* s) : String(StringView(s)) {}
+    String(char const* s, size_type n) : String(StringView(s, n)) {}
+    explicit String(StringView sv) {
+        setSmallSize(0);
+        append(sv);
+    }
+    String(size_type n, char c) {
+        setSmallSize(0);
+        resize(n, c);
+    }
+
+    String(String const& that) {
+        if (that.isSmall()) {
+            std::memcpy(m_small, that.m_small, sizeof(m_small));
+        } else {
+            setSmallSize(0);
+            append(StringView(that));
+        }
+    }
+
+    String(String&& that) noexcept {
+        std::memcpy(m_small, that.m_small, sizeof(m_small));
+        that.setSmallSize(0);
+    }
+
+    String& operator=(String const& that) {
+        return *this = StringView(that);
+    }
+
+    String& operator=(String&& that) noexcept {
+        swap(that);
+        return *this;
+    }
+
+    // 复用已有的容量; sv 指向自身时 n <= size(), reserve 不会重新分配
+    String& operator=(StringView sv) {
+        size_type n = sv.size();
+        char* p = reserveData(n);
+        if (n)
+            std::memmove(p, sv.data(), n);
+        setSize(p, n);
+        return *this;
+    }
+
+    ~String() {
+        if (!isSmall())
+            std::allocator<char>().deallocate(m_heap.ptr, capacity() + 1);
+    }
+
+    void swap(String& that) noexcept {
+        char tmp[sizeof(m_small)];
+        std::memcpy(tmp, m_small, sizeof(m_small));
+        std::memcpy(m_small, that.m_small, sizeof(m_small));
+        std::memcpy(that.m_small, tmp, sizeof(m_small));
+    }
+
+    operator StringView() const noexcept { return {data(), size()}; }
+    operator std::string_view() const noexcept { return {data(), size()}; }
+
+    // element access
+
+    char* data() noexcept { return isSmall() ? m_small : m_heap.ptr; }
+    char const* data() const noexcept {
+        return isSmall() ? m_small : m_heap.ptr;
+    }
+    char const* c_str() const noexcept { return data(); }
+
+    char& operator[](size_type i) noexcept { return data()[i]; }
+    char operator[](size_type i) const noexcept { return data()[i]; }
+
+    char& at(size_type i) {
+        if (i >= size()) [[unlikely]]
+            throw std::out_of_range("string::at out_of_range");
+        return data()[i];
+    }
+
+    char& front() noexcept { return data()[0]; }
+    char& back() noexcept { return data()[size() - 1]; }
+
+    iterator begin() noexcept { return data(); }
+    const_iterator begin() const noexcept { return data(); }
+    iterator end() noexcept { return data() + size(); }
+    const_iterator end() const noexcept { return data() + size(); }
+
+    // about size
+
+    bool empty() const noexcept { return size() == 0; }
+    size_type size() const noexcept {
+        return isSmall() ? kSmallCapacity -
+                               static_cast<unsigned char>(m_small[kLast])
+                         : m_heap.size;
+    }
+    size_type length() const noexcept { return size(); }
+    size_type capacity() const noexcept {
+        return isSmall() ? kSmallCapacity : m_heap.cap & ~kHeapFlag;
+    }
+    bool is_small() const noexcept { return isSmall(); }
+
+    void reserve(size_type n) { reserveData(n); }
+
+    // modifier
+
+    void clear() noexcept { setSize(data(), 0); }
+
+    void push_back(char c) {
+        size_type len = size();
+        char* p = reserveData(len + 1);
+        p[len] = c;
+        setSize(p, len + 1);
+    }
+
+    void pop_back() noexcept { setSize(data(), size() - 1); }
+
+    String& append(StringView sv) {
+        size_type len = size();
+        // sv 可能指向自身, 先记下偏移
+        char const* src = sv.data();
+        bool self = src >= data() && src < data() + len;
+        size_type offset = self ? static_cast<size_type>(src - data()) : 0;
+        char* p = reserveData(len + sv.size());
+        if (self)
+            src = p + offset;
+        if (sv.size())
+            std::memmove(p + len, src, sv.size());
+        setSize(p, len + sv.size());
+        return *this;
+    }
+    String& append(char const* s, size_type n) {
+        return append(StringView(s, n));
+    }
+
+    String& operator+=(StringView sv) { return append(sv); }
+    String& operator+=(char c) {
+        push_back(c);
+        return *this;
+    }
+
+    void resize(size_type n, char c = '\0') {
+        size_type len = size();
+        char* p = reserveData(n);
+        if (n > len)
+            std::memset(p + len, c, n - len);
+        setSize(p, n);
+    }
+
+    // op(char* p, size_type n) 写入 [p, p+n), 返回实际长度(<= n)
+    // 调用前 [size(), n) 中的内容未指定, 省掉resize时的清零
+    template <typename Op> void resize_and_overwrite(size_type n, Op op) {
+        char* p = reserveData(n);
+        auto len = static_cast<size_type>(std::move(op)(p, n));
+        setSize(p, len);
+    }
+
+    // string operations
+
+    size_type find(char c, size_type pos = 0) const noexcept {
+        return StringView(*this).find(c, pos);
+    }
+    size_type find(StringView needle, size_type pos = 0) const noexcept {
+        return StringView(*this).find(needle, pos);
+    }
+    bool contains(StringView needle) const noexcept {
+        return find(needle) != npos;
+    }
+    bool starts_with(StringView s) const noexcept {
+        return StringView(*this).starts_with(s);
+    }
+    bool ends_with(StringView s) const noexcept {
+        return StringView(*this).ends_with(s);
+    }
+    int compare(StringView that) const noexcept {
+        return StringView(*this).compare(that);
+    }
+    String substr(size_type pos, size_type n = npos) const {
+        return String(StringView(*this).substr(pos, n));
+    }
+
+    std::size_t hash() const noexcept { return StringView(*this).hash(); }
+
+    friend bool operator==(String const& a, StringView b) noexcept {
+        return StringView(a) == b;
+    }
+    friend std::strong_ordering operator<=>(String const& a,
+                                            StringView b) noexcept {
+        return StringView(a) <=> b;
+    }
+
+    friend String operator+(String a, StringView b) {
+        a.append(b);
+        return a;
+    }
+
+  private:
+    static constexpr size_type kLast = 23;
+    static constexpr size_type kHeapFlag = size_type(1)
+                                           << (sizeof(size_type) * 8 - 1);
+
+    // 扩容是冷路径, 不内联, 短字符串的热路径保持很小
+    [[gnu::noinline]] char* grow(size_type n) {
+        n = std::max(n, capacity() * 2);
+        size_type len = size();
+        char* fresh = std::allocator<char>().allocate(n + 1);
+        std::memcpy(fresh, data(), len + 1);
+        if (!isSmall())
+            std::allocator<char>().deallocate(m_heap.ptr, capacity() + 1);
+        m_heap.ptr = fresh;
+        m_heap.size = len;
+        m_heap.cap = n | kHeapFlag;
+        return fresh;
+    }
+
+    // 返回容量至少为n的缓冲区
+    char* reserveData(size_type n) {
+        if (n > capacity()) [[unlikely]]
+            return grow(n);
+        return data();
+    }
+
+    bool isSmall() const noexcept {
+        return !(static_cast<unsigned char>(m_small[kLast]) & 0x80);
+    }
+
+    void setSmallSize(size_type n) noexcept {
+        m_small[n] = '\0';
+        m_small[kLast] = static_cast<char>(kSmallCapacity - n);
+    }
+
+    // p 是当前的data()
+    void setSize(char* p, size_type n) noexcept {
+        p[n] = '\0';
+        if (isSmall())
+            m_small[kLast] = static_cast<char>(kSmallCapacity - n);
+        else
+            m_heap.size = n;
+    }
+
+    struct Heap {
+        char* ptr;
+        size_type size;
+        size_type cap; // 最高位是长模式标记
+    };
+    union {
+        Heap m_heap;
+        char m_small[sizeof(Heap)] = {};
+    };
+};
+static_assert(sizeof(String) == 24);
+
+// 透明哈希, 可以用StringView/字面量直接查 unordered_map<String, ...>
+struct StringHash {
+    using is_transparent = void;
+    std::size_t operator()(StringView sv) const noexcept { return sv.hash(); }
+};
+
+template <> struct IsTriviallyRelocatable<String> : std::true_type {};
+} // namespace lstl
+
+template <> struct std::hash<lstl::StringView> {
+    std::size_t operator()(lstl::StringView sv) const noexcept {
+        return sv.hash();
+    }
+};
+
+template <> struct std::hash<lstl::String> {
+    std::size_t operator()(lstl::String const& s) const noexcept {
+        return s.hash();
+    }
+};
@@ -0,0 +1,11 @@
+#pragma once
+#include <type_traits>
+namespace lstl {
+// 可以用memcpy搬到新地址并且不调用旧对象析构函数的类型
+// 平凡可复制的类型天然满足; 其余类型(比如UniquePtr)需要自己特化
+template <typename T>
+struct IsTriviallyRelocatable : std::is_trivially_copyable<T> {};
+
+template <typename T>
+inline constexpr bool isTriviallyRelocatable = IsTriviallyRelocatable<T>::value;
+} // namespace lstl
@@ -1,21 +1,53 @@
 #pragma once
 #include <cstddef>
+#include <memory>
+#include <type_traits>
 #include <utility>
+
+#include "lstl/TypeTraits.hpp"
+
 namespace lstl {
 template <typename T> struct DefaultDeleter {
     constexpr DefaultDeleter() noexcept = default;
-    template <typename U> DefaultDeleter(const DefaultDeleter<U>&) noexcept {}
-    void operator()(T* p) { delete p; }
+    template <typename U>
+        requires std::is_convertible_v<U*, T*>
+    DefaultDeleter(const DefaultDeleter<U>&) noexcept {}
+    void operator()(T* p) const noexcept {
+        static_assert(sizeof(T) > 0, "can't delete an incomplete type");
+        delete p;
+    }
 };
 template <typename T> struct DefaultDeleter<T[]> {
     constexpr DefaultDeleter() noexcept = default;
-    template <typename U> DefaultDeleter(const DefaultDeleter<U>&) noexcept {}
-    void operator()(T* p) { delete[] p; }
+    template <typename U>
+        requires std::is_convertible_v<U (*)[], T (*)[]>
+    DefaultDeleter(const DefaultDeleter<U[]>&) noexcept {}
+    void operator()(T* p) const noexcept {
+        static_assert(sizeof(T) > 0, "can't delete an incomplete type");
+        delete[] p;
+    }
 };
+
+// 通过分配器释放的deleter, 无状态分配器不占空间
+template <typename Alloc> struct AllocDeleter {
+    using value_type = typename std::allocator_traits<Alloc>::value_type;
+
+    [[no_unique_address]] Alloc m_alloc;
+
+    AllocDeleter() = default;
+    explicit AllocDeleter(Alloc const& alloc) : m_alloc(alloc) {}
+
+    void operator()(value_type* p) {
+        std::allocator_traits<Alloc>::destroy(m_alloc, p);
+        std::allocator_traits<Alloc>::deallocate(m_alloc, p, 1);
+    }
+};
+
+// 压缩存储: 无状态的Deleter不占空间, 有状态的原地存放
 template <typename T, typename Deleter = DefaultDeleter<T>>
-class LUniquePtrData {
-    T* p;
-    Deleter d;
+struct LUniquePtrData {
+    T* m_p;
+    [[no_unique_address]] Deleter m_d;
 };
 
 template <typename T, typename Deleter = DefaultDeleter<T>> class UniquePtr {
@@ -26,51 +58,205 @@ template <typename T, typename Deleter = DefaultDeleter<T>> class UniquePtr {
     using deleter_type = Deleter;
 
     // ctors
-    UniquePtr() noexcept : m_p(nullptr) {}
-    UniquePtr(std::nullptr_t) noexcept : m_p(nullptr) {}
+    UniquePtr() noexcept
+        requires std::is_default_constructible_v<Deleter>
+        : m_data{nullptr, Deleter()} {}
+    UniquePtr(std::nullptr_t) noexcept
+        requires std::is_default_constructible_v<Deleter>
+        : m_data{nullptr, Deleter()} {}
 
-    explicit UniquePtr(pointer p) noexcept : m_p(p) {}
+    explicit UniquePtr(pointer p) noexcept
+        requires std::is_default_constructible_v<Deleter>
+        : m_data{p, Deleter()} {}
 
-    UniquePtr(UniquePtr&& that) noexcept {
-        m_p = std::exchange(that.m_p, nullptr);
-    }
+    UniquePtr(pointer p, Deleter const& d) noexcept : m_data{p, d} {}
+    UniquePtr(pointer p, Deleter&& d) noexcept : m_data{p, std::move(d)} {}
 
-    template <typename U>
-    UniquePtr(UniquePtr<U> that) noexcept : m_p(that.m_p) {}
+    UniquePtr(UniquePtr&& that) noexcept
+        : m_data{that.release(), std::forward<Deleter>(that.get_deleter())} {}
+
+    template <typename U, typename E>
+        requires std::is_convertible_v<U*, T*> &&
+                     std::is_convertible_v<E, Deleter>
+    UniquePtr(UniquePtr<U, E>&& that) noexcept
+        : m_data{that.release(), std::forward<E>(that.get_deleter())} {}
 
     UniquePtr(const UniquePtr&) = delete;
+    UniquePtr& operator=(const UniquePtr&) = delete;
 
-    pointer* release() { return std::exchange(m_p, nullptr); }
+    ~UniquePtr() {
+        if (m_data.m_p)
+            m_data.m_d(m_data.m_p);
+    }
 
-    void reset(pointer p) {
-        if (m_p)
-            Deleter{}(m_p);
-        m_p = p;
+    UniquePtr& operator=(UniquePtr&& that) noexcept {
+        reset(that.release());
+        m_data.m_d = std::forward<Deleter>(that.get_deleter());
+        return *this;
     }
 
-    pointer get() const { return m_p; }
+    template <typename U, typename E>
+        requires std::is_convertible_v<U*, T*> &&
+                 std::is_assignable_v<Deleter&, E&&>
+    UniquePtr& operator=(UniquePtr<U, E>&& that) noexcept {
+        reset(that.release());
+        m_data.m_d = std::forward<E>(that.get_deleter());
+        return *this;
+    }
+
+    UniquePtr& operator=(std::nullptr_t) noexcept {
+        reset();
+        return *this;
+    }
+
+    pointer release() noexcept { return std::exchange(m_data.m_p, nullptr); }
+
+    // 先换上新指针再删旧的, 防止旧对象的析构函数重入*this
+    void reset(pointer p = nullptr) noexcept {
+        pointer old = std::exchange(m_data.m_p, p);
+        if (old)
+            m_data.m_d(old);
+    }
+
+    void swap(UniquePtr& that) noexcept {
+        std::swap(m_data.m_p, that.m_data.m_p);
+        std::swap(m_data.m_d, that.m_data.m_d);
+    }
 
-    T& operator*() const { return *m_p; }
+    pointer get() const noexcept { return m_data.m_p; }
 
-    pointer operator->() const { return m_p; }
+    Deleter& get_deleter() noexcept { return m_data.m_d; }
+    Deleter const& get_deleter() const noexcept { return m_data.m_d; }
+
+    explicit operator bool() const noexcept { return m_data.m_p != nullptr; }
+
+    T& operator*() const { return *m_data.m_p; }
+
+    pointer operator->() const noexcept { return m_data.m_p; }
 
   private:
-    pointer m_p;
+    LUniquePtrData<T, Deleter> m_data;
+};
 
-    template <typename U, class UDeleter> friend class UniquePtr;
+template <typename T, typename Deleter> class UniquePtr<T[], Deleter> {
+  public:
+    using pointer = T*;
+    using element_type = T;
+    using deleter_type = Deleter;
+
+    UniquePtr() noexcept
+        requires std::is_default_constructible_v<Deleter>
+        : m_data{nullptr, Deleter()} {}
+    UniquePtr(std::nullptr_t) noexcept
+        requires std::is_default_constructible_v<Deleter>
+        : m_data{nullptr, Deleter()} {}
+
+    // 数组版本不接受派生类指针, delete[]基类指针是UB
+    explicit UniquePtr(pointer p) noexcept
+        requires std::is_default_constructible_v<Deleter>
+        : m_data{p, Deleter()} {}
+
+    UniquePtr(pointer p, Deleter const& d) noexcept : m_data{p, d} {}
+    UniquePtr(pointer p, Deleter&& d) noexcept : m_data{p, std::move(d)} {}
+
+    UniquePtr(UniquePtr&& that) noexcept
+        : m_data{that.release(), std::forward<Deleter>(that.get_deleter())} {}
+
+    UniquePtr(const UniquePtr&) = delete;
+    UniquePtr& operator=(const UniquePtr&) = delete;
+
+    ~UniquePtr() {
+        if (m_data.m_p)
+            m_data.m_d(m_data.m_p);
+    }
+
+    UniquePtr& operator=(UniquePtr&& that) noexcept {
+        reset(that.release());
+        m_data.m_d = std::forward<Deleter>(that.get_deleter());
+        return *this;
+    }
+
+    UniquePtr& operator=(std::nullptr_t) noexcept {
+        reset();
+        return *this;
+    }
+
+    pointer release() noexcept { return std::exchange(m_data.m_p, nullptr); }
+
+    void reset(pointer p = nullptr) noexcept {
+        pointer old = std::exchange(m_data.m_p, p);
+        if (old)
+            m_data.m_d(old);
+    }
+
+    void swap(UniquePtr& that) noexcept {
+        std::swap(m_data.m_p, that.m_data.m_p);
+        std::swap(m_data.m_d, that.m_data.m_d);
+    }
+
+    pointer get() const noexcept { return m_data.m_p; }
+
+    Deleter& get_deleter() noexcept { return m_data.m_d; }
+    Deleter const& get_deleter() const noexcept { return m_data.m_d; }
+
+    explicit operator bool() const noexcept { return m_data.m_p != nullptr; }
+
+    T& operator[](std::size_t i) const { return m_data.m_p[i]; }
+
+  private:
+    LUniquePtrData<T, Deleter> m_data;
 };
 
+template <typename T, typename D1, typename U, typename D2>
+bool operator==(UniquePtr<T, D1> const& a, UniquePtr<U, D2> const& b) noexcept {
+    return a.get() == b.get();
+}
+template <typename T, typename D>
+bool operator==(UniquePtr<T, D> const& a, std::nullptr_t) noexcept {
+    return !a;
+}
+
+// UniquePtr本身只是一个指针加一个deleter, 搬家时不需要调用析构函数
 template <typename T, typename Deleter>
-class UniquePtr<T[], Deleter> : public UniquePtr<T, Deleter> {};
+struct IsTriviallyRelocatable<UniquePtr<T, Deleter>>
+    : IsTriviallyRelocatable<Deleter> {};
 
-template <typename T> UniquePtr<T> makeUnique() {
-    return UniquePtr<T>(new T());
-}
 template <typename T, typename... Args>
+    requires(!std::is_array_v<T>)
 UniquePtr<T> makeUnique(Args&&... args) {
     return UniquePtr<T>(new T(std::forward<Args>(args)...));
 }
-template <typename T> UniquePtr<T> makeUniqueForOverwrite() {
+template <typename T>
+    requires std::is_unbounded_array_v<T>
+UniquePtr<T> makeUnique(std::size_t n) {
+    return UniquePtr<T>(new std::remove_extent_t<T>[n]());
+}
+template <typename T>
+    requires(!std::is_array_v<T>)
+UniquePtr<T> makeUniqueForOverwrite() {
     return UniquePtr<T>(new T);
 }
+template <typename T>
+    requires std::is_unbounded_array_v<T>
+UniquePtr<T> makeUniqueForOverwrite(std::size_t n) {
+    return UniquePtr<T>(new std::remove_extent_t<T>[n]);
+}
+
+// 用分配器分配并构造, 返回的UniquePtr在销毁时把内存还给该分配器
+template <typename T, typename Alloc, typename... Args>
+    requires(!std::is_array_v<T>)
+auto allocateUnique(Alloc const& alloc, Args&&... args) {
+    using Traits =
+        typename std::allocator_traits<Alloc>::template rebind_traits<T>;
+    using TAlloc = typename Traits::allocator_type;
+    TAlloc a(alloc);
+    T* p = Traits::allocate(a, 1);
+    try {
+        Traits::construct(a, p, std::forward<Args>(args)...);
+    } catch (...) {
+        Traits::deallocate(a, p, 1);
+        throw;
+    }
+    return UniquePtr<T, AllocDeleter<TAlloc>>(p, AllocDeleter<TAlloc>(a));
+}
 } // namespace lstl
@@ -9,6 +9,9 @@
 #include <stdexcept>
 #include <utility>
 
+#include "lstl/Instrument.hpp"
+#include "lstl/TypeTraits.hpp"
+
 namespace lstl {
 template <typename T, typename Alloc = std::allocator<T>> class Vector {
   public:
@@ -41,16 +44,16 @@ template <typename T, typename Alloc = std::allocator<T>> class Vector {
     Vector() noexcept(noexcept(Alloc())) : Vector(Alloc()) {}
 
     // (2)
-    explicit Vector(const Alloc& alloc = Alloc())
+    explicit Vector(const Alloc& alloc) noexcept
         : m_data(nullptr), m_size(0), m_capacity(0), m_alloc(alloc) {}
 
     // (3)
     explicit Vector(std::size_t n, Alloc const& alloc = Alloc())
         : m_alloc(alloc) {
-        m_data = m_alloc.allocate(n);
+        m_data = allocate(n);
         m_capacity = n;
         m_size = n;
-        for (std::size_t i = 0; i <= n; i++) {
+        for (std::size_t i = 0; i != n; i++) {
             std::construct_at(&m_data[i]);
             // 对placement new 的包装
             // 调用::new 并转发Args
@@ -61,12 +64,9 @@ template <typename T, typename Alloc = std::allocator<T>> class Vector {
     // (4)
     Vector(std::size_t n, T const& value, Alloc const& alloc = Alloc())
         : m_alloc(alloc) {
-        m_data = m_alloc.allocate(n);
+        m_data = allocate(n);
         m_capacity = n;
         m_size = n;
-#ifndef NDEBUG
-        std::cout << m_data << "\n";
-#endif
         for (std::size_t i = 0; i != n; i++) {
             std::construct_at(&m_data[i], value);
         }
@@ -85,7 +85,7 @@ template <typename T, typename Alloc = std::allocator<T>> class Vector {
             Alloc const& alloc = Alloc())
         : m_alloc(alloc) {
         std::size_t n = last - first;
-        m_data = m_alloc.allocate(n);
+        m_data = allocate(n);
         m_capacity = m_size = n;
         for (std::size_t i = 0; i < n; i++) {
             std::construct_at(&m_data[i], *first);
@@ -101,7 +101,7 @@ template <typename T, typename Alloc = std::allocator<T>> class Vector {
         m_capacity = that.m_size;
         m_size = that.m_size;
         if (m_size) {
-            m_data = m_alloc.allocate(m_size);
+            m_data = allocate(m_size);
             for (std::size_t i = 0; i != m_size; i++) {
                 std::construct_at(&m_data[i],
                                   std::move_if_noexcept(that.m_data[i]));
@@ -123,7 +123,7 @@ template <typename T, typename Alloc = std::allocator<T>> class Vector {
         m_capacity = that.m_size;
         m_size = that.m_size;
         if (m_size) {
-            m_data = m_alloc.allocate(m_size);
+            m_data = allocate(m_size);
             for (std::size_t i = 0; i != m_size; i++) {
                 std::construct_at(&m_data[i],
                                   std::move_if_noexcept(that.m_data[i]));
@@ -152,7 +152,7 @@ template <typename T, typename Alloc = std::allocator<T>> class Vector {
             std::destroy_at(&m_data[i]);
         }
         if (m_capacity != 0) {
-            m_alloc.deallocate(m_data, m_capacity);
+            deallocate(m_data, m_capacity);
         }
     }
 
@@ -179,7 +179,7 @@ template <typename T, typename Alloc = std::allocator<T>> class Vector {
             std::destroy_at(&m_data[i]);
         }
         if (m_capacity) {
-            m_alloc.deallocate(m_data, m_capacity);
+            deallocate(m_data, m_capacity);
         }
         m_data = std::exchange(that.m_data, nullptr);
         m_size = std::exchange(that.m_size, 0);
@@ -338,43 +338,33 @@ template <typename T, typename Alloc = std::allocator<T>> class Vector {
             m_data = nullptr;
             m_capacity = 0;
         } else {
-            m_data = m_alloc.allocate(n);
+            m_data = allocate(n);
             m_capacity = n;
         }
         if (old_capacity) {
-            for (std::size_t i = 0; i != m_size; i++) {
-                std::construct_at(&m_data[i],
-                                  std::move_if_noexcept(old_data[i]));
-            }
-            for (std::size_t i = 0; i != m_size; i++) {
-                std::destroy_at(&old_data[i]);
-            }
-            m_alloc.deallocate(old_data, old_capacity);
+            LSTL_COUNT(instrument::VectorTag, reallocations, 1);
+            LSTL_PROBE(vector_realloc, old_capacity, m_capacity);
+            relocate(m_data, old_data, m_size);
+            deallocate(old_data, old_capacity);
         }
     }
 
     size_type capacity() const noexcept { return m_capacity; }
 
     void shrink_to_fit() noexcept {
+        LSTL_COUNT(instrument::VectorTag, shrinkToFit, 1);
+        LSTL_PROBE(vector_shrink, m_capacity, m_size);
         auto old_data = m_data;
         auto old_capacity = m_capacity;
         m_capacity = m_size;
         if (m_size == 0) {
             m_data = nullptr;
         } else {
-            m_data = m_alloc.allocate(m_size);
+            m_data = allocate(m_size);
         }
         if (old_capacity != 0) [[likely]] {
-            // ?
-            for (std::size_t i = 0; i != old_capacity; i++) {
-                std::construct_at(&m_data[i],
-                                  std::move_if_noexcept(old_data[i]));
-                // 强异常安全
-                // 只有T 移动构造noexcept 和禁止复制构造时, 返回T&&
-                // 否则返回const T&
-                std::destroy_at(&old_data[i]);
-            }
-            m_alloc.deallocate(old_data, old_capacity);
+            relocate(m_data, old_data, m_size);
+            deallocate(old_data, old_capacity);
         }
     }
 
@@ -574,5 +564,45 @@ template <typename T, typename Alloc = std::allocator<T>> class Vector {
     bool operator>(T const& that) const noexcept { return that < *this; }
     bool operator<=(T const& that) const noexcept { return !(that < *this); }
     bool operator>=(T const& that) const noexcept { return !(that > *this); }
+
+  private:
+    // 所有分配都经过这里, 方便 LSTL_INSTRUMENT 计数
+    T* allocate(std::size_t n) {
+        LSTL_COUNT(instrument::VectorTag, allocations, 1);
+        LSTL_COUNT(instrument::VectorTag, bytesRequested, n * sizeof(T));
+        return m_alloc.allocate(n);
+    }
+
+    void deallocate(T* p, std::size_t n) noexcept {
+        LSTL_COUNT(instrument::VectorTag, deallocations, 1);
+        LSTL_COUNT(instrument::VectorTag, bytesFreed, n * sizeof(T));
+        m_alloc.deallocate(p, n);
+    }
+
+    // 把n个元素从src搬到未初始化的dst, 并结束src中对象的生命周期
+    static void relocate(T* dst, T* src, std::size_t n) {
+        if constexpr (isTriviallyRelocatable<T> ||
+                      std::is_nothrow_move_constructible_v<T> ||
+                      !std::is_copy_constructible_v<T>)
+            LSTL_COUNT(instrument::VectorTag, elementsMoved, n);
+        else
+            LSTL_COUNT(instrument::VectorTag, elementsCopied, n);
+        if constexpr (isTriviallyRelocatable<T>) {
+            // 可平凡重定位的类型直接memcpy, 不调用移动构造和析构
+            if (n)
+                std::memcpy(static_cast<void*>(dst),
+                            static_cast<void const*>(src), n * sizeof(T));
+        } else {
+            for (std::size_t i = 0; i != n; i++) {
+                // 强异常安全
+                // 只有T 移动构造noexcept 和禁止复制构造时, 返回T&&
+                // 否则返回const T&
+                std::construct_at(&dst[i], std::move_if_noexcept(src[i]));
+            }
+            for (std::size_t i = 0; i != n; i++) {
+                std::destroy_at(&src[i]);
+            }
+        }
+    }
 };
 } // namespace lstl
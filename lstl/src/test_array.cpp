@@ -0,0 +1,115 @@
+#include "catch2/catch_test_macros.hpp"
+#include "lstl/Array.hpp"
+#include "lstl/InplaceVector.hpp"
+#include <string>
+
+namespace {
+constexpr lstl::Array<unsigned, 16> makeSquares() {
+    lstl::Array<unsigned, 16> a{};
+    for (unsigned i = 0; i < a.size(); i++)
+        a[i] = i * i;
+    return a;
+}
+
+constexpr lstl::InplaceVector<int, 8> makeEvens() {
+    lstl::InplaceVector<int, 8> v;
+    for (int i = 0; v.try_push_back(2 * i); i++) {
+    }
+    return v;
+}
+
+constexpr lstl::InplaceVector<int, 8> makeEdited() {
+    lstl::InplaceVector<int, 8> v{1, 5};
+    v.insert(v.begin() + 1, {2, 3, 4});
+    v.erase(v.begin(), v.begin() + 1);
+    return v;
+}
+
+struct NoDefault {
+    explicit NoDefault(int v) : value(v) {}
+    int value;
+};
+} // namespace
+
+TEST_CASE("constexpr", "[array]") {
+    constexpr auto squares = makeSquares();
+    static_assert(squares[15] == 225);
+    static_assert(squares.back() == 225);
+
+    constexpr int raw[] = {3, 1, 2};
+    constexpr auto a = lstl::toArray(raw);
+    static_assert(a.size() == 3 && a[0] == 3);
+    static_assert(lstl::toArray({1, 2}) < lstl::toArray({1, 3}));
+
+    constexpr lstl::Array b{1, 2, 3};
+    static_assert(*b.rbegin() == 3);
+    static_assert(*(b.rend() - 1) == 1);
+
+    constexpr auto evens = makeEvens();
+    static_assert(evens.size() == 8 && evens.back() == 14);
+    constexpr auto edited = makeEdited();
+    static_assert(edited.size() == 4 && edited[0] == 2 && edited[3] == 5);
+}
+
+TEST_CASE("inplace vector", "[array]") {
+    lstl::InplaceVector<std::string, 2> v;
+    v.push_back("a");
+    v.emplace_back(3, 'b');
+    REQUIRE(v.try_push_back("c") == nullptr);
+    REQUIRE_THROWS_AS(v.push_back("c"), std::bad_alloc);
+    REQUIRE(v[1] == "bbb");
+    auto w = v;
+    v.erase(v.begin());
+    REQUIRE(v.size() == 1);
+    REQUIRE(v.front() == "bbb");
+    REQUIRE(w.size() == 2);
+    REQUIRE(w.at(0) == "a");
+}
+
+TEST_CASE("no default constructor", "[array]") {
+    lstl::Array<NoDefault, 0> none{};
+    REQUIRE(none.empty());
+    REQUIRE(none.begin() == none.end());
+    REQUIRE(none.data() == nullptr);
+
+    lstl::InplaceVector<NoDefault, 4> v;
+    v.emplace_back(1);
+    v.emplace_back(2);
+    REQUIRE(v.back().value == 2);
+    lstl::InplaceVector<NoDefault, 0> empty;
+    REQUIRE(empty.try_emplace_back(1) == nullptr);
+}
+
+TEST_CASE("inplace vector editing", "[array]") {
+    using Strings = lstl::InplaceVector<std::string, 6>;
+    Strings v{"a", "d"};
+    REQUIRE(*v.insert(v.begin() + 1, "b") == "b");
+    v.emplace(v.begin() + 2, 1, 'c');
+    v.insert(v.end(), 2, "e");
+    REQUIRE(v == Strings{"a", "b", "c", "d", "e", "e"});
+
+    // 满了之后插入失败, 内容不变
+    std::string extra[] = {"x", "y"};
+    REQUIRE_THROWS_AS(v.insert(v.begin(), extra, extra + 2), std::bad_alloc);
+    REQUIRE_THROWS_AS(v.insert(v.begin(), v.front()), std::bad_alloc);
+    REQUIRE(v.size() == 6);
+
+    REQUIRE(*v.erase(v.begin() + 1, v.begin() + 4) == "e");
+    REQUIRE(v == Strings{"a", "e", "e"});
+    v.insert(v.begin(), v[2]); // 插入自身的元素
+    REQUIRE(v == Strings{"e", "a", "e", "e"});
+    v.insert(v.begin() + 1, extra, extra + 2);
+    REQUIRE(v == Strings{"e", "x", "y", "a", "e", "e"});
+
+    Strings w;
+    w.assign(3, "z");
+    v.swap(w);
+    REQUIRE(v == Strings{"z", "z", "z"});
+    REQUIRE(w.size() == 6);
+    REQUIRE(w[2] == "y");
+    w.assign({"p", "q"});
+    REQUIRE(w == Strings{"p", "q"});
+    w.assign(extra, extra + 1);
+    REQUIRE(w == Strings{"x"});
+    REQUIRE_THROWS_AS(w.assign(7, "too many"), std::bad_alloc);
+}
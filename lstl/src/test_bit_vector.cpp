@@ -0,0 +1,88 @@
+#include "catch2/catch_test_macros.hpp"
+#include "lstl/BitVector.hpp"
+#include <random>
+#include <vector>
+
+TEST_CASE("growable bits", "[bit_vector]") {
+    lstl::BitVector bits;
+    for (int i = 0; i < 200; i++)
+        bits.push_back(i % 3 == 0);
+    REQUIRE(bits.size() == 200);
+    REQUIRE(bits[3]);
+    REQUIRE_FALSE(bits[4]);
+    REQUIRE(bits.popcount() == 67);
+
+    bits[4] = true;
+    bits.flip(3);
+    REQUIRE(bits.test(4));
+    REQUIRE_FALSE(bits.test(3));
+
+    bits.resize(70);
+    REQUIRE(bits.popcount() == 24);
+    bits.resize(130, true);
+    REQUIRE(bits.popcount() == 84);
+    REQUIRE(bits.words().back() == (std::uint64_t(1) << 2) - 1);
+    while (bits.size() > 64)
+        bits.pop_back();
+    REQUIRE(bits.words().size() == 1);
+
+    bits.flip();
+    REQUIRE(bits.popcount() == 64 - 22);
+    bits.set();
+    REQUIRE(bits.all());
+    bits.reset();
+    REQUIRE(bits.none());
+}
+
+TEST_CASE("bulk operations and scan", "[bit_vector]") {
+    lstl::BitVector a(1000), b(1000);
+    for (std::size_t i = 0; i < 1000; i += 2)
+        a.set(i);
+    for (std::size_t i = 0; i < 1000; i += 3)
+        b.set(i);
+    REQUIRE((a & b).popcount() == 167);
+    REQUIRE((a | b).popcount() == 500 + 334 - 167);
+    REQUIRE((a ^ b).popcount() == 500 + 334 - 2 * 167);
+    lstl::BitVector c = a;
+    c.andnot(b);
+    REQUIRE(c.popcount() == 500 - 167);
+    REQUIRE_THROWS_AS(a &= lstl::BitVector(10), std::invalid_argument);
+
+    lstl::BitVector sparse(5000);
+    sparse.set(70);
+    sparse.set(4999);
+    REQUIRE(sparse.find_first() == 70);
+    REQUIRE(sparse.find_next(70) == 4999);
+    REQUIRE(sparse.find_next(4999) == lstl::BitVector::npos);
+    REQUIRE(sparse.find_next(lstl::BitVector::npos) ==
+            lstl::BitVector::npos);
+    REQUIRE(sparse.find_next(6000) == lstl::BitVector::npos);
+    REQUIRE(lstl::BitVector(10).find_first() == lstl::BitVector::npos);
+}
+
+TEST_CASE("rank and select", "[bit_vector]") {
+    std::mt19937 rng(3);
+    lstl::BitVector bits;
+    std::vector<std::size_t> ones;
+    for (std::size_t i = 0; i < 10000; i++) {
+        bool on = rng() % 7 == 0 || (i >= 3000 && i < 4000);
+        bits.push_back(on);
+        if (on)
+            ones.push_back(i);
+    }
+    lstl::RankSelect index(bits);
+    REQUIRE(index.count() == ones.size());
+    bool ok = true;
+    for (std::size_t k = 0; k != ones.size(); k++) {
+        ok = ok && index.select(k) == ones[k];
+        ok = ok && index.rank(ones[k]) == k;
+    }
+    REQUIRE(ok);
+    REQUIRE(index.rank(bits.size()) == ones.size());
+    REQUIRE(index.select(ones.size()) == lstl::RankSelect::npos);
+
+    lstl::RankSelect empty;
+    REQUIRE(empty.count() == 0);
+    REQUIRE(empty.rank(0) == 0);
+    REQUIRE(empty.select(0) == lstl::RankSelect::npos);
+}
@@ -0,0 +1,88 @@
+#include "catch2/catch_test_macros.hpp"
+#include "lstl/ConcurrentVector.hpp"
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+TEST_CASE("stable addresses", "[concurrent_vector]") {
+    lstl::ConcurrentVector<std::string> v;
+    std::string* first = &v.push_back("first");
+    for (int i = 0; i < 1000; i++)
+        v.emplace_back(std::to_string(i));
+    REQUIRE(first == &v[0]);
+    REQUIRE(*first == "first");
+    REQUIRE(v.size() == 1001);
+    REQUIRE(v[1000] == "999");
+    REQUIRE(v.grow_by(3, "x") == 1001);
+    REQUIRE(v.at(1003) == "x");
+}
+
+namespace {
+int g_live = 0;
+
+struct Picky {
+    explicit Picky(int v) : value(v) {
+        if (v < 0)
+            throw std::invalid_argument("negative");
+        g_live++;
+    }
+    Picky(Picky&& that) noexcept : value(that.value) { g_live++; }
+    ~Picky() { g_live--; }
+    int value;
+};
+} // namespace
+
+TEST_CASE("throwing constructor", "[concurrent_vector]") {
+    {
+        lstl::ConcurrentVector<Picky> v;
+        v.emplace_back(1);
+        REQUIRE_THROWS_AS(v.emplace_back(-1), std::invalid_argument);
+        v.emplace_back(3);
+        int batch[] = {4, -5, 6};
+        REQUIRE_THROWS_AS(v.grow_by(batch, batch + 3), std::invalid_argument);
+        REQUIRE(v.size() == 6);
+        REQUIRE(g_live == 3);
+
+        auto flat = v.freeze();
+        REQUIRE(flat.size() == 3);
+        REQUIRE(flat[2].value == 4);
+        REQUIRE(g_live == 3);
+        REQUIRE_THROWS_AS(v.emplace_back(-1), std::invalid_argument);
+    }
+    REQUIRE(g_live == 0);
+}
+
+TEST_CASE("concurrent append", "[concurrent_vector]") {
+    lstl::ConcurrentVector<long> v;
+    constexpr long kPerThread = 20000;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; t++) {
+        threads.emplace_back([&v, t] {
+            for (long i = 0; i < kPerThread; i += 4) {
+                long base = t * kPerThread + i;
+                if (i % 8 == 0) {
+                    long batch[4] = {base, base + 1, base + 2, base + 3};
+                    v.grow_by(batch, batch + 4);
+                } else {
+                    for (long j = 0; j < 4; j++)
+                        v.push_back(base + j);
+                }
+            }
+        });
+    }
+    for (auto& t : threads)
+        t.join();
+    REQUIRE(v.size() == 4 * kPerThread);
+
+    auto flat = v.freeze();
+    REQUIRE(v.empty());
+    REQUIRE(flat.size() == 4 * kPerThread);
+    std::vector<bool> seen(4 * kPerThread);
+    for (long x : flat)
+        seen[static_cast<std::size_t>(x)] = true;
+    bool all = true;
+    for (bool b : seen)
+        all = all && b;
+    REQUIRE(all);
+}
@@ -0,0 +1,60 @@
+#include "catch2/catch_test_macros.hpp"
+#include "lstl/Deque.hpp"
+#include "lstl/IncrementalVector.hpp"
+#include <algorithm>
+#include <string>
+
+TEST_CASE("both ends", "[deque]") {
+    lstl::Deque<int> d;
+    for (int i = 0; i < 5000; i++) {
+        d.push_back(i);
+        d.push_front(-i - 1);
+    }
+    REQUIRE(d.size() == 10000);
+    REQUIRE(d.front() == -5000);
+    REQUIRE(d.back() == 4999);
+    REQUIRE(d[5000] == 0);
+    REQUIRE(std::is_sorted(d.begin(), d.end()));
+    REQUIRE(*d.rbegin() == 4999);
+    while (d.size() > 1) {
+        d.pop_front();
+        d.pop_back();
+    }
+    REQUIRE(d.size() == 0);
+}
+
+TEST_CASE("stable references", "[deque]") {
+    lstl::StableVector<std::string> v;
+    v.push_back("anchor");
+    std::string* anchor = &v.front();
+    for (int i = 0; i < 10000; i++)
+        v.emplace_back(std::to_string(i));
+    REQUIRE(anchor == &v[0]);
+    REQUIRE(*anchor == "anchor");
+
+    // 当作队列用, 已用的块会被回收
+    for (int i = 0; i < 100000; i++) {
+        v.push_back("x");
+        v.pop_front();
+    }
+    REQUIRE(v.size() == 10001);
+    REQUIRE(v.back() == "x");
+    auto copy = v;
+    REQUIRE(copy.size() == v.size());
+}
+
+TEST_CASE("incremental vector", "[deque]") {
+    lstl::IncrementalVector<std::string> v;
+    bool sawMigration = false;
+    for (int i = 0; i < 1000; i++) {
+        v.push_back(std::to_string(i));
+        sawMigration = sawMigration || v.migrating();
+        if (v[static_cast<std::size_t>(i / 2)] != std::to_string(i / 2))
+            FAIL("element lost during migration");
+    }
+    REQUIRE(sawMigration);
+    v.pop_back();
+    REQUIRE(v.back() == "998");
+    REQUIRE(v.data()[500] == "500");
+    REQUIRE(!v.migrating());
+}
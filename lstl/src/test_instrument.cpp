@@ -0,0 +1,49 @@
+#include "catch2/catch_test_macros.hpp"
+#include "lstl/Instrument.hpp"
+#include "lstl/Map.hpp"
+#include "lstl/Vector.hpp"
+
+namespace {
+struct ParserTag {
+    static constexpr char const* name = "parser";
+};
+} // namespace
+
+TEST_CASE("tracking allocator", "[instrument]") {
+    using Alloc = lstl::instrument::TrackingAllocator<int, ParserTag>;
+    {
+        lstl::Vector<int, Alloc> v{Alloc()};
+        for (int i = 0; i < 100; i++)
+            v.push_back(i);
+    }
+    auto s = lstl::instrument::snapshot<ParserTag>();
+    REQUIRE(s.allocations > 0);
+    REQUIRE(s.allocations == s.deallocations);
+    REQUIRE(s.bytesRequested == s.bytesFreed);
+    REQUIRE(lstl::instrument::snapshot("parser").allocations == s.allocations);
+}
+
+#ifdef LSTL_INSTRUMENT
+TEST_CASE("container counters", "[instrument]") {
+    using lstl::instrument::SetTag;
+    using lstl::instrument::VectorTag;
+    lstl::instrument::reset();
+    {
+        lstl::Vector<int> v;
+        v.reserve(4);
+        for (int i = 0; i < 4; i++)
+            v.push_back(i);
+        v.shrink_to_fit();
+    }
+    auto s = lstl::instrument::snapshot<VectorTag>();
+    REQUIRE(s.reallocations >= 1);
+    REQUIRE(s.elementsMoved >= 4);
+    REQUIRE(s.shrinkToFit == 1);
+    REQUIRE(s.allocations == s.deallocations);
+
+    lstl::Set set;
+    set.insert(1);
+    set.insert(2);
+    REQUIRE(lstl::instrument::snapshot<SetTag>().nodeAllocations == 2);
+}
+#endif
@@ -0,0 +1,48 @@
+#include "catch2/catch_test_macros.hpp"
+#include "lstl/IntrusivePtr.hpp"
+
+namespace {
+int g_destroyed = 0;
+
+struct Route : lstl::RefCounted<Route> {
+    int id;
+    explicit Route(int i) : id(i) {}
+    lstl::IntrusivePtr<Route> self() { return lstl::IntrusivePtr<Route>(this); }
+};
+
+struct Local;
+struct CountingDestroy {
+    void operator()(Local* p);
+};
+struct Local : lstl::RefCounted<Local, lstl::PlainRefCount, CountingDestroy> {
+};
+void CountingDestroy::operator()(Local* p) {
+    g_destroyed++;
+    delete p;
+}
+} // namespace
+
+TEST_CASE("from this", "[intrusive_ptr]") {
+    static_assert(sizeof(lstl::IntrusivePtr<Route>) == sizeof(void*));
+    auto p = lstl::makeIntrusive<Route>(7);
+    REQUIRE(p->use_count() == 1);
+    auto q = p->self();
+    REQUIRE(q == p);
+    REQUIRE(p->use_count() == 2);
+    q.reset();
+    REQUIRE(p->use_count() == 1);
+}
+
+TEST_CASE("destroy hook", "[intrusive_ptr]") {
+    // 无状态的Deleter不占空间
+    static_assert(sizeof(Local) == sizeof(long));
+    g_destroyed = 0;
+    {
+        auto p = lstl::makeIntrusive<Local>();
+        auto q = p;
+        auto r = std::move(q);
+        REQUIRE(!q);
+        REQUIRE(r->use_count() == 2);
+    }
+    REQUIRE(g_destroyed == 1);
+}
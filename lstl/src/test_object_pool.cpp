@@ -0,0 +1,125 @@
+#include "catch2/catch_test_macros.hpp"
+#include "lstl/ObjectPool.hpp"
+#include <atomic>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace {
+std::atomic<int> g_alive{0};
+struct Request {
+    int id;
+    explicit Request(int i = 0) : id(i) { g_alive++; }
+    ~Request() { g_alive--; }
+    void reset() { id = -1; }
+};
+
+using PacketDeleter = lstl::PoolDeleter<struct Packet>;
+struct Packet : lstl::RefCounted<Packet, lstl::AtomicRefCount, PacketDeleter> {
+    int len;
+    Packet(PacketDeleter deleter, int n)
+        : RefCounted(deleter), len(n) {}
+    // 拷贝到池子的另一个槽位, 带上新槽位的Deleter
+    Packet(PacketDeleter deleter, Packet const& that)
+        : RefCounted(that, deleter), len(that.len) {}
+};
+
+// 有状态的Deleter不能被默认构造出来
+struct Bare : lstl::RefCounted<Bare, lstl::AtomicRefCount,
+                               lstl::PoolDeleter<Bare>> {};
+static_assert(!std::is_default_constructible_v<Bare>);
+static_assert(!std::is_copy_constructible_v<Bare>);
+static_assert(!std::is_copy_constructible_v<Packet>);
+
+template <typename Pool>
+concept AcquireWithArgs = requires(Pool& pool) { pool.acquire(6); };
+static_assert(AcquireWithArgs<lstl::ObjectPool<Request>>);
+static_assert(
+    !AcquireWithArgs<lstl::ObjectPool<Request, lstl::PoolRecycle::Reset>>);
+} // namespace
+
+TEST_CASE("recycle", "[object_pool]") {
+    {
+        lstl::ObjectPool<Request> pool(4);
+        auto a = pool.acquire(1);
+        Request* addr = a.get();
+        REQUIRE(a->id == 1);
+        a.reset();
+        REQUIRE(g_alive == 0);
+        auto b = pool.acquire(2);
+        REQUIRE(b.get() == addr);
+        REQUIRE(b->id == 2);
+
+        auto c = pool.acquire();
+        auto d = pool.acquire();
+        auto e = pool.acquire();
+        auto f = pool.acquire();
+        auto st = pool.stats();
+        REQUIRE(st.live == 5);
+        REQUIRE(st.highWater == 5);
+        REQUIRE(st.slabs == 2);
+        REQUIRE(st.capacity == 8);
+    }
+    REQUIRE(g_alive == 0);
+}
+
+TEST_CASE("reset instead of destroy", "[object_pool]") {
+    {
+        lstl::ObjectPool<Request, lstl::PoolRecycle::Reset> pool(2, 2);
+        REQUIRE(pool.stats().capacity == 2);
+        auto first = pool.acquire();
+        first->id = 5;
+        first.reset();
+        REQUIRE(g_alive == 1);
+        // 复用的对象是归还时reset()过的状态
+        auto p = pool.acquire();
+        REQUIRE(p->id == -1);
+        REQUIRE(g_alive == 1);
+    }
+    REQUIRE(g_alive == 0);
+}
+
+TEST_CASE("threads", "[object_pool]") {
+    lstl::ObjectPool<Request> pool(16);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; t++) {
+        threads.emplace_back([&pool, t] {
+            for (int i = 0; i < 10000; i++) {
+                auto a = pool.acquire(t);
+                auto b = pool.acquire(i);
+                a.reset();
+            }
+        });
+    }
+    for (auto& t : threads)
+        t.join();
+    auto st = pool.stats();
+    REQUIRE(st.live == 0);
+    REQUIRE(st.highWater <= 8);
+    REQUIRE(g_alive == 0);
+}
+
+TEST_CASE("intrusive handles", "[object_pool]") {
+    lstl::ObjectPool<Packet> pool(4);
+    auto a = pool.acquireIntrusive(64);
+    Packet* addr = a.get();
+    auto b = a;
+    REQUIRE(a->use_count() == 2);
+    REQUIRE(pool.stats().live == 1);
+    a.reset();
+    REQUIRE(pool.stats().live == 1);
+    b.reset();
+    REQUIRE(pool.stats().live == 0);
+    auto c = pool.acquireIntrusive(32);
+    REQUIRE(c.get() == addr);
+    REQUIRE(c->len == 32);
+
+    auto copy = pool.acquireIntrusive(*c);
+    REQUIRE(copy.get() != c.get());
+    REQUIRE(copy->len == 32);
+    REQUIRE(copy->use_count() == 1);
+    REQUIRE(pool.stats().live == 2);
+    c.reset();
+    copy.reset();
+    REQUIRE(pool.stats().live == 0);
+}
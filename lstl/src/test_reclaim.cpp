@@ -0,0 +1,108 @@
+#include "catch2/catch_test_macros.hpp"
+#include "lstl/Reclaim.hpp"
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace {
+std::atomic<int> g_alive{0};
+struct Node {
+    int value;
+    explicit Node(int v) : value(v) { g_alive++; }
+    ~Node() { g_alive--; }
+};
+
+// 释放时再退休下一个节点, 模拟析构时退休子节点
+std::atomic<int> g_chainFreed{0};
+struct Chain {
+    Chain* next;
+};
+template <bool Ebr> void dropChain(void* p) {
+    auto* c = static_cast<Chain*>(p);
+    if (c->next) {
+        if constexpr (Ebr)
+            lstl::ebr::retire(c->next, &dropChain<Ebr>);
+        else
+            lstl::hazard::retire(c->next, &dropChain<Ebr>);
+    }
+    delete c;
+    g_chainFreed++;
+}
+} // namespace
+
+TEST_CASE("epoch", "[reclaim]") {
+    std::atomic<Node*> head{new Node(0)};
+    std::atomic<bool> stop{false};
+    std::atomic<int> errors{0};
+    std::vector<std::thread> readers;
+    for (int t = 0; t < 3; t++) {
+        readers.emplace_back([&] {
+            while (!stop.load(std::memory_order_relaxed)) {
+                lstl::ebr::Guard g;
+                Node* p = head.load(std::memory_order_acquire);
+                if (p->value < 0)
+                    errors++;
+            }
+        });
+    }
+    for (int i = 1; i <= 10000; i++) {
+        Node* old = head.exchange(new Node(i), std::memory_order_acq_rel);
+        lstl::ebr::retire(old);
+    }
+    stop = true;
+    for (auto& t : readers)
+        t.join();
+    lstl::ebr::synchronize();
+    REQUIRE(errors == 0);
+    REQUIRE(g_alive == 1);
+    delete head.load();
+}
+
+TEST_CASE("hazard pointer", "[reclaim]") {
+    std::atomic<Node*> head{new Node(0)};
+    std::atomic<bool> stop{false};
+    std::atomic<int> errors{0};
+    std::vector<std::thread> readers;
+    for (int t = 0; t < 3; t++) {
+        readers.emplace_back([&] {
+            lstl::hazard::HazardPointer hp;
+            while (!stop.load(std::memory_order_relaxed)) {
+                Node* p = hp.protect(head);
+                if (p->value < 0)
+                    errors++;
+                hp.reset();
+            }
+        });
+    }
+    for (int i = 1; i <= 10000; i++) {
+        Node* old = head.exchange(new Node(i), std::memory_order_acq_rel);
+        lstl::hazard::retire(old);
+        // 未释放的对象数量有上界
+        if (g_alive > 2 + 2 * 64)
+            errors++;
+    }
+    stop = true;
+    for (auto& t : readers)
+        t.join();
+    lstl::hazard::scan();
+    REQUIRE(errors == 0);
+    REQUIRE(g_alive == 1);
+    delete head.load();
+}
+
+TEST_CASE("retire from deleter", "[reclaim]") {
+    g_chainFreed = 0;
+    for (int i = 0; i < 200; i++)
+        lstl::ebr::retire(new Chain{new Chain{new Chain{nullptr}}},
+                          &dropChain<true>);
+    lstl::ebr::synchronize();
+    REQUIRE(g_chainFreed == 600);
+
+    g_chainFreed = 0;
+    for (int i = 0; i < 200; i++)
+        lstl::hazard::retire(new Chain{new Chain{new Chain{nullptr}}},
+                             &dropChain<false>);
+    for (int i = 0; i < 3; i++)
+        lstl::hazard::scan();
+    REQUIRE(g_chainFreed == 600);
+}
@@ -0,0 +1,150 @@
+#include "catch2/catch_test_macros.hpp"
+#include "lstl/Ring.hpp"
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+TEST_CASE("spsc basic", "[ring]") {
+    lstl::SpscRing<int, 4> q;
+    for (int i = 0; i < 4; i++)
+        REQUIRE(q.try_push(i));
+    REQUIRE(!q.try_push(4));
+    int out = -1;
+    REQUIRE(q.try_pop(out));
+    REQUIRE(out == 0);
+
+    int batch[4] = {10, 11, 12, 13};
+    REQUIRE(q.push_n(batch, 4) == 1);
+    int got[8] = {};
+    REQUIRE(q.pop_n(got, 8) == 4);
+    REQUIRE(got[0] == 1);
+    REQUIRE(got[3] == 10);
+    REQUIRE(q.empty());
+}
+
+TEST_CASE("spsc threads", "[ring]") {
+    lstl::SpscRing<long, 64> q;
+    constexpr long kCount = 200000;
+    std::thread producer([&] {
+        long buf[16];
+        long next = 0;
+        while (next < kCount) {
+            long n = std::min<long>(16, kCount - next);
+            for (long i = 0; i < n; i++)
+                buf[i] = next + i;
+            std::size_t done = 0;
+            while (done < static_cast<std::size_t>(n)) {
+                auto k = static_cast<std::size_t>(n) - done;
+                if (std::size_t pushed = q.push_n(buf + done, k))
+                    done += pushed;
+                else
+                    std::this_thread::yield();
+            }
+            next += n;
+        }
+    });
+    // 两边都用批量接口轮询
+    long sum = 0;
+    bool ordered = true;
+    long got[16];
+    for (long i = 0; i < kCount;) {
+        auto n = static_cast<long>(q.pop_n(got, 16));
+        if (n == 0)
+            std::this_thread::yield();
+        for (long j = 0; j < n; j++) {
+            ordered = ordered && got[j] == i + j;
+            sum += got[j];
+        }
+        i += n;
+    }
+    producer.join();
+    REQUIRE(ordered);
+    REQUIRE(sum == kCount * (kCount - 1) / 2);
+}
+
+TEST_CASE("spsc blocking", "[ring]") {
+    lstl::SpscRing<long, 8> q;
+    constexpr long kCount = 200000;
+    std::thread producer([&] {
+        for (long i = 0; i < kCount; i++)
+            q.push(i);
+    });
+    bool ordered = true;
+    for (long i = 0; i < kCount; i++)
+        ordered = q.pop() == i && ordered;
+    producer.join();
+    REQUIRE(ordered);
+    REQUIRE(q.empty());
+}
+
+TEST_CASE("blocking pop with batch producer", "[ring]") {
+    lstl::SpscRing<long, 16> q;
+    constexpr long kCount = 100000;
+    std::thread producer([&] {
+        long buf[8];
+        for (long next = 0; next < kCount;) {
+            long n = std::min<long>(8, kCount - next);
+            for (long i = 0; i < n; i++)
+                buf[i] = next + i;
+            std::size_t done = 0;
+            while (done < static_cast<std::size_t>(n)) {
+                auto k = static_cast<std::size_t>(n) - done;
+                if (std::size_t pushed = q.push_n(buf + done, k))
+                    done += pushed;
+                else
+                    std::this_thread::yield();
+            }
+            next += n;
+            // 偶尔停一下, 让消费者真正挂起
+            if (next % 4096 == 0)
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    });
+    bool ordered = true;
+    for (long i = 0; i < kCount; i++)
+        ordered = q.pop() == i && ordered;
+    producer.join();
+    REQUIRE(ordered);
+
+    // 满的一方挂在push里, 对方用pop_n取
+    std::thread pusher([&] {
+        for (long i = 0; i < kCount; i++)
+            q.push(i);
+    });
+    long got[8];
+    long sum = 0;
+    for (long i = 0; i < kCount;) {
+        auto n = static_cast<long>(q.pop_n(got, 8));
+        if (n == 0)
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+        for (long j = 0; j < n; j++)
+            sum += got[j];
+        i += n;
+    }
+    pusher.join();
+    REQUIRE(sum == kCount * (kCount - 1) / 2);
+}
+
+TEST_CASE("mpmc threads", "[ring]") {
+    lstl::MpmcRing<long> q(100);
+    REQUIRE(q.capacity() == 128);
+    constexpr long kPerThread = 50000;
+    std::atomic<long> sum{0};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 2; t++) {
+        threads.emplace_back([&] {
+            for (long i = 1; i <= kPerThread; i++)
+                q.push(i);
+        });
+        threads.emplace_back([&] {
+            long local = 0;
+            for (long i = 0; i < kPerThread; i++)
+                local += q.pop();
+            sum += local;
+        });
+    }
+    for (auto& t : threads)
+        t.join();
+    REQUIRE(sum == 2 * kPerThread * (kPerThread + 1) / 2);
+}
@@ -0,0 +1,170 @@
+#include "catch2/catch_test_macros.hpp"
+#include "lstl/Serialize.hpp"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <unistd.h>
+
+namespace {
+struct Padded {
+    char tag;
+    long value;
+};
+
+bool sameBytes(lstl::Vector<std::byte> const& a,
+               lstl::Vector<std::byte> const& b) {
+    return std::equal(a.begin(), a.end(), b.begin(), b.end());
+}
+
+std::size_t depthOf(lstl::Node const* node) {
+    if (!node)
+        return 0;
+    return 1 + std::max(depthOf(node->left), depthOf(node->right));
+}
+} // namespace
+
+TEST_CASE("pod round trip", "[serialize]") {
+    lstl::Vector<int> v;
+    for (int i = 0; i < 1001; i++) // 补齐到1002个int
+        v.push_back(i * 3);
+    auto bytes = lstl::toBytes(v);
+    REQUIRE(bytes.size() == sizeof(lstl::BlobHeader) + 1002 * sizeof(int));
+
+    lstl::Vector<int> out;
+    lstl::fromBytes({bytes.data(), bytes.size()}, out);
+    REQUIRE(out.size() == v.size());
+    REQUIRE(std::equal(out.begin(), out.end(), v.begin()));
+
+    lstl::Array<double, 3> a{1.5, 2.5, 3.5};
+    lstl::Array<double, 3> b{};
+    auto ab = lstl::toBytes(a);
+    lstl::fromBytes({ab.data(), ab.size()}, b);
+    REQUIRE(a == b);
+}
+
+TEST_CASE("nested and set", "[serialize]") {
+    lstl::Vector<lstl::Vector<short>> nested;
+    for (short i = 0; i < 10; i++)
+        nested.push_back(lstl::Vector<short>(static_cast<std::size_t>(i), i));
+    auto bytes = lstl::toBytes(nested);
+    lstl::Vector<lstl::Vector<short>> out;
+    lstl::fromBytes({bytes.data(), bytes.size()}, out);
+    REQUIRE(out.size() == 10);
+    for (std::size_t i = 0; i != 10; i++) {
+        REQUIRE(out[i].size() == i);
+        for (short x : out[i])
+            REQUIRE(x == static_cast<short>(i));
+    }
+
+    lstl::Set s;
+    for (int x : {50, 20, 80, 10, 30, 70, 90})
+        s.insert(x);
+    auto sb = lstl::toBytes(s);
+    lstl::SetView view({sb.data(), sb.size()});
+    REQUIRE(view.size() == 7);
+    REQUIRE(std::is_sorted(view.begin(), view.end()));
+    REQUIRE(view.contains(70));
+    REQUIRE_FALSE(view.contains(60));
+    lstl::Set copy;
+    lstl::fromBytes({sb.data(), sb.size()}, copy);
+    REQUIRE(copy.find(30));
+}
+
+TEST_CASE("large set is rebuilt balanced", "[serialize]") {
+    constexpr int kCount = 100000;
+    lstl::Vector<int> keys;
+    for (int i = 0; i < kCount; i++)
+        keys.push_back(i * 2);
+    std::shuffle(keys.begin(), keys.end(), std::mt19937(42));
+    lstl::Set s;
+    for (int x : keys)
+        s.insert(x);
+    auto bytes = lstl::toBytes(s);
+
+    lstl::Set copy;
+    copy.insert(-7); // 反序列化前已有的内容会被清掉
+    lstl::fromBytes({bytes.data(), bytes.size()}, copy);
+    REQUIRE_FALSE(copy.find(-7));
+    REQUIRE(depthOf(copy.root) == 17); // ceil(log2(kCount + 1))
+    REQUIRE(copy.find(2 * (kCount - 1)));
+    REQUIRE_FALSE(copy.find(3));
+    REQUIRE(sameBytes(lstl::toBytes(copy), bytes));
+    s.clear();
+    copy.clear();
+    REQUIRE(copy.root == nullptr);
+}
+
+TEST_CASE("padding is zeroed", "[serialize]") {
+    lstl::Vector<Padded> a(3, Padded{});
+    lstl::Vector<Padded> b(3, Padded{});
+    std::memset(static_cast<void*>(a.data()), 0x00, 3 * sizeof(Padded));
+    std::memset(static_cast<void*>(b.data()), 0xff, 3 * sizeof(Padded));
+    for (std::size_t i = 0; i != 3; i++) {
+        a[i].tag = b[i].tag = static_cast<char>('a' + i);
+        a[i].value = b[i].value = static_cast<long>(i) * 100;
+    }
+    auto ab = lstl::toBytes(a);
+    REQUIRE(sameBytes(ab, lstl::toBytes(b)));
+
+    // long double 的值只占一部分字节, 剩下的也要清零
+    lstl::Vector<long double> la(4, 1.5L);
+    lstl::Vector<long double> lb(4, 1.5L);
+    std::memset(static_cast<void*>(la.data()), 0x00, 4 * sizeof(long double));
+    std::memset(static_cast<void*>(lb.data()), 0xff, 4 * sizeof(long double));
+    for (std::size_t i = 0; i != 4; i++)
+        la[i] = lb[i] = static_cast<long double>(i) + 0.25L;
+    REQUIRE(sameBytes(lstl::toBytes(la), lstl::toBytes(lb)));
+    lstl::Vector<Padded> out;
+    lstl::fromBytes({ab.data(), ab.size()}, out);
+    REQUIRE(out.size() == 3);
+    REQUIRE(out[2].tag == 'c');
+    REQUIRE(out[2].value == 200);
+}
+
+TEST_CASE("corrupt blobs are rejected", "[serialize]") {
+    lstl::Vector<long> v(100, 7L);
+    auto bytes = lstl::toBytes(v);
+    lstl::Vector<long> out;
+
+    auto flipped = bytes;
+    flipped[sizeof(lstl::BlobHeader) + 5] ^= std::byte{1};
+    REQUIRE_THROWS_AS(lstl::fromBytes({flipped.data(), flipped.size()}, out),
+                      lstl::SerializeError);
+    REQUIRE_THROWS_AS(lstl::fromBytes({bytes.data(), bytes.size() - 8}, out),
+                      lstl::SerializeError);
+    lstl::Vector<int> wrongType;
+    REQUIRE_THROWS_AS(
+        lstl::fromBytes({bytes.data(), bytes.size()}, wrongType),
+        lstl::SerializeError);
+
+    lstl::Set s;
+    s.insert(1);
+    auto sb = lstl::toBytes(s);
+    lstl::Vector<std::byte> shifted(sb.size() + 1, std::byte{0});
+    std::memcpy(shifted.data() + 1, sb.data(), sb.size());
+    REQUIRE_THROWS_AS(lstl::SetView({shifted.data() + 1, sb.size()}),
+                      lstl::SerializeError);
+}
+
+TEST_CASE("writev and mmap view", "[serialize]") {
+    lstl::Vector<std::uint32_t> v;
+    for (std::uint32_t i = 0; i < 100000; i++)
+        v.push_back(i ^ 0x5a5a);
+    char path[] = "/tmp/lstl_serializeXXXXXX";
+    int fd = mkstemp(path);
+    REQUIRE(fd >= 0);
+    lstl::BlobWriter w;
+    lstl::serialize(w, v);
+    w.writeTo(fd);
+    close(fd);
+    {
+        lstl::MappedFile file(path);
+        REQUIRE(file.bytes().size() == w.size());
+        lstl::VectorView<std::uint32_t> view(file.bytes());
+        REQUIRE(view.size() == v.size());
+        REQUIRE(view[12345] == v[12345]);
+        REQUIRE(std::equal(view.begin(), view.end(), v.begin()));
+    }
+    std::remove(path);
+}
@@ -0,0 +1,77 @@
+#include "catch2/catch_test_macros.hpp"
+#include "lstl/AtomicSharedPtr.hpp"
+#include "lstl/SharedPtr.hpp"
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace {
+std::atomic<int> g_alive{0};
+struct Config {
+    int version;
+    explicit Config(int v) : version(v) { g_alive++; }
+    ~Config() { g_alive--; }
+};
+} // namespace
+
+TEST_CASE("refcount", "[shared_ptr]") {
+    {
+        auto p = lstl::makeShared<Config>(1);
+        REQUIRE(p.use_count() == 1);
+        auto q = p;
+        REQUIRE(p.use_count() == 2);
+        auto r = std::move(q);
+        REQUIRE(!q);
+        REQUIRE(r->version == 1);
+        REQUIRE(p.use_count() == 2);
+    }
+    REQUIRE(g_alive == 0);
+}
+
+TEST_CASE("load store exchange", "[atomic_shared_ptr]") {
+    {
+        lstl::AtomicSharedPtr<Config> a(lstl::makeShared<Config>(1));
+        auto p = a.load();
+        REQUIRE(p->version == 1);
+        REQUIRE(p.use_count() == 2);
+
+        auto old = a.exchange(lstl::makeShared<Config>(2));
+        REQUIRE(old == p);
+        REQUIRE(a.load()->version == 2);
+
+        auto expected = old;
+        REQUIRE(!a.compare_exchange(expected, lstl::makeShared<Config>(3)));
+        REQUIRE(expected->version == 2);
+        REQUIRE(a.compare_exchange(expected, lstl::makeShared<Config>(4)));
+        REQUIRE(a.load()->version == 4);
+    }
+    REQUIRE(g_alive == 0);
+}
+
+TEST_CASE("concurrent reload", "[atomic_shared_ptr]") {
+    {
+        lstl::AtomicSharedPtr<Config> a(lstl::makeShared<Config>(0));
+        std::atomic<bool> stop{false};
+        std::atomic<int> errors{0};
+        std::vector<std::thread> readers;
+        for (int t = 0; t < 4; t++) {
+            readers.emplace_back([&] {
+                int last = 0;
+                while (!stop.load(std::memory_order_relaxed)) {
+                    auto p = a.load();
+                    if (p->version < last)
+                        errors++;
+                    last = p->version;
+                }
+            });
+        }
+        for (int v = 1; v <= 20000; v++)
+            a.store(lstl::makeShared<Config>(v));
+        stop = true;
+        for (auto& t : readers)
+            t.join();
+        REQUIRE(errors == 0);
+        REQUIRE(a.load()->version == 20000);
+    }
+    REQUIRE(g_alive == 0);
+}
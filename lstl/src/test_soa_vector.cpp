@@ -0,0 +1,158 @@
+#include "catch2/catch_test_macros.hpp"
+#include "lstl/SoAVector.hpp"
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+
+namespace geo {
+// 通过ADL提供get的结构体, 不能用std::apply
+struct Point {
+    int x;
+    double y;
+};
+
+template <std::size_t I> auto const& get(Point const& p) {
+    if constexpr (I == 0)
+        return p.x;
+    else
+        return p.y;
+}
+} // namespace geo
+
+template <> struct std::tuple_size<geo::Point> {
+    static constexpr std::size_t value = 2;
+};
+template <> struct std::tuple_element<0, geo::Point> {
+    using type = int;
+};
+template <> struct std::tuple_element<1, geo::Point> {
+    using type = double;
+};
+
+namespace {
+int g_live = 0;
+
+struct Tracked {
+    Tracked() { g_live++; }
+    Tracked(Tracked const&) { g_live++; }
+    ~Tracked() { g_live--; }
+};
+
+int g_brittle = 0;
+int g_copyBudget = -1; // 为0时下一次拷贝抛异常, 负数表示不限
+
+// 没有noexcept的移动构造, 扩容时会被拷贝
+struct Brittle {
+    explicit Brittle(int v) : value(v) { g_brittle++; }
+    Brittle(Brittle const& that) : value(that.value) {
+        if (g_copyBudget >= 0 && g_copyBudget-- == 0)
+            throw std::runtime_error("copy");
+        g_brittle++;
+    }
+    ~Brittle() { g_brittle--; }
+    int value;
+};
+
+struct Fussy {
+    explicit Fussy(int v) : value(v) {
+        if (v < 0)
+            throw std::invalid_argument("negative");
+    }
+    int value;
+};
+} // namespace
+
+TEST_CASE("columns", "[soa_vector]") {
+    lstl::SoAVector<int, float, std::uint64_t> v;
+    for (int i = 0; i < 100; i++)
+        v.push_back(i, static_cast<float>(i) * 0.5f,
+                    static_cast<std::uint64_t>(i) * 1000);
+    v.push_back(std::tuple{100, 50.0f, std::uint64_t(100000)});
+    REQUIRE(v.size() == 101);
+
+    auto scores = v.column<1>();
+    REQUIRE(reinterpret_cast<std::uintptr_t>(scores.data()) % 64 == 0);
+    float sum = 0;
+    for (float s : scores)
+        sum += s;
+    REQUIRE(sum == 2525.0f);
+
+    auto [id, score, ts] = v[42];
+    REQUIRE(id == 42);
+    REQUIRE(ts == 42000);
+    score = -1.0f;
+    REQUIRE(v.get<1>(42) == -1.0f);
+}
+
+TEST_CASE("non trivial field", "[soa_vector]") {
+    lstl::SoAVector<std::string, int> v;
+    v.push_back(std::pair<std::string, int>{"a", 1});
+    v.emplace_back(std::string(40, 'b'), 2);
+    auto w = v;
+    v.pop_back();
+    REQUIRE(v.size() == 1);
+    REQUIRE(std::get<0>(w.at(1)) == std::string(40, 'b'));
+    REQUIRE(w.column<1>()[1] == 2);
+}
+
+TEST_CASE("user defined row", "[soa_vector]") {
+    lstl::SoAVector<int, double> v;
+    v.push_back(geo::Point{1, 2.5});
+    geo::Point const p{3, 4.5};
+    v.push_back(p);
+    REQUIRE(v.size() == 2);
+    REQUIRE(v.get<0>(1) == 3);
+    REQUIRE(v.get<1>(0) == 2.5);
+}
+
+TEST_CASE("row from itself", "[soa_vector]") {
+    lstl::SoAVector<std::string, int> v;
+    v.emplace_back(std::string(40, 'a'), 0);
+    for (int i = 1; i < 20; i++) {
+        v.push_back(v[0]);
+        v.emplace_back(v.get<0>(0), v.get<1>(i));
+    }
+    REQUIRE(v.size() == 39);
+    REQUIRE(v.get<0>(38) == std::string(40, 'a'));
+}
+
+TEST_CASE("throwing column", "[soa_vector]") {
+    {
+        lstl::SoAVector<Tracked, Fussy> v;
+        v.emplace_back(Tracked(), 1);
+        REQUIRE_THROWS_AS(v.emplace_back(Tracked(), -1),
+                          std::invalid_argument);
+        REQUIRE(v.size() == 1);
+        REQUIRE(g_live == 1);
+        v.reserve(8);
+        REQUIRE_THROWS_AS(v.emplace_back(Tracked(), -1),
+                          std::invalid_argument);
+        REQUIRE(g_live == 1);
+    }
+    REQUIRE(g_live == 0);
+}
+
+TEST_CASE("reserve is all or nothing", "[soa_vector]") {
+    {
+        lstl::SoAVector<std::string, Brittle, int> v;
+        for (int i = 0; i < 5; i++)
+            v.emplace_back(std::string(30, static_cast<char>('a' + i)), i, i);
+        auto cap = v.capacity();
+        g_copyBudget = 2;
+        REQUIRE_THROWS_AS(v.reserve(cap * 4), std::runtime_error);
+        g_copyBudget = -1;
+        REQUIRE(v.capacity() == cap);
+        REQUIRE(v.size() == 5);
+        REQUIRE(g_brittle == 5);
+        for (int i = 0; i < 5; i++) {
+            REQUIRE(v.get<0>(static_cast<std::size_t>(i)) ==
+                    std::string(30, static_cast<char>('a' + i)));
+            REQUIRE(v.get<1>(static_cast<std::size_t>(i)).value == i);
+        }
+        v.reserve(cap * 4);
+        REQUIRE(v.capacity() >= cap * 4);
+        REQUIRE(v.get<0>(4) == std::string(30, 'e'));
+        REQUIRE(g_brittle == 5);
+    }
+    REQUIRE(g_brittle == 0);
+}
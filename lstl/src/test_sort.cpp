@@ -0,0 +1,107 @@
+#include "catch2/catch_test_macros.hpp"
+#include "lstl/Sort.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <stdexcept>
+
+namespace {
+struct Keyed {
+    explicit Keyed(int k) : key(k) {}
+    int key;
+};
+
+template <typename T>
+concept SortableByKey = requires(lstl::Vector<T>& v) {
+    lstl::sort(v, [](T const& r) { return r.key; });
+};
+// scratch 由resize得到, 记录必须可默认构造
+static_assert(!SortableByKey<Keyed>);
+} // namespace
+
+TEST_CASE("arithmetic keys", "[sort]") {
+    std::mt19937_64 rng(42);
+    lstl::Vector<std::int32_t> ints;
+    for (int i = 0; i < 10000; i++)
+        ints.push_back(static_cast<std::int32_t>(rng()));
+    ints.push_back(std::numeric_limits<std::int32_t>::min());
+    ints.push_back(std::numeric_limits<std::int32_t>::max());
+    lstl::Vector<std::int32_t> expected(ints);
+    std::sort(expected.begin(), expected.end());
+    lstl::sort(ints);
+    REQUIRE(std::equal(ints.begin(), ints.end(), expected.begin()));
+
+    lstl::Vector<double> doubles;
+    std::uniform_real_distribution<double> dist(-1e6, 1e6);
+    for (int i = 0; i < 5000; i++)
+        doubles.push_back(dist(rng));
+    doubles.push_back(-std::numeric_limits<double>::infinity());
+    doubles.push_back(0.0);
+    lstl::sort(doubles);
+    REQUIRE(std::is_sorted(doubles.begin(), doubles.end()));
+    REQUIRE(doubles.front() == -std::numeric_limits<double>::infinity());
+
+    lstl::Vector<float> small{3.5f, -1.0f, 2.0f, -7.25f};
+    lstl::sort(small);
+    REQUIRE(std::is_sorted(small.begin(), small.end()));
+    // 大小不是1/2/4/8字节的算术类型退回std::sort
+    static_assert(lstl::RadixKey<long double> == (sizeof(long double) <= 8));
+    lstl::Vector<long double> wide;
+    for (int i = 0; i < 1000; i++)
+        wide.push_back(static_cast<long double>(dist(rng)));
+    lstl::sort(wide);
+    REQUIRE(std::is_sorted(wide.begin(), wide.end()));
+}
+
+TEST_CASE("key extractor is stable", "[sort]") {
+    struct Record {
+        std::uint16_t key;
+        int order;
+    };
+    std::mt19937 rng(7);
+    lstl::Vector<Record> v;
+    for (int i = 0; i < 20000; i++)
+        v.push_back({static_cast<std::uint16_t>(rng() % 100), i});
+    lstl::Vector<Record> scratch;
+    lstl::sort(v, [](Record const& r) { return r.key; }, scratch);
+    REQUIRE(scratch.size() >= v.size());
+    REQUIRE(std::is_sorted(v.begin(), v.end(), [](auto& a, auto& b) {
+        return a.key != b.key ? a.key < b.key : a.order < b.order;
+    }));
+}
+
+TEST_CASE("parallel radix", "[sort]") {
+    std::mt19937_64 rng(1);
+    lstl::Vector<std::uint64_t> v;
+    for (int i = 0; i < (1 << 21) + 3; i++)
+        v.push_back(rng() >> (i % 3 == 0 ? 40 : 0));
+    lstl::Vector<std::uint64_t> expected(v);
+    std::sort(expected.begin(), expected.end());
+    lstl::Vector<std::uint64_t> w(v);
+    lstl::sort(v);
+    REQUIRE(std::equal(v.begin(), v.end(), expected.begin()));
+
+    // 不依赖机器核数, 直接用4个线程跑并行版本
+    lstl::Vector<std::uint64_t> scratch(w);
+    lstl::detail::RadixIdentity key;
+    REQUIRE(lstl::detail::parallelRadixSort(w.data(), scratch.data(),
+                                            w.size(), key, 4));
+    REQUIRE(std::equal(w.begin(), w.end(), expected.begin()));
+}
+
+TEST_CASE("throwing key propagates", "[sort]") {
+    struct Record {
+        int key;
+    };
+    lstl::Vector<Record> v;
+    for (int i = 0; i < (1 << 20) + 5; i++)
+        v.push_back({(i % 1000) * 7 % 1000});
+    // 没有声明noexcept的key不走多线程, 异常可以正常传出来
+    auto key = [](Record const& r) {
+        if (r.key == 999)
+            throw std::runtime_error("bad key");
+        return r.key;
+    };
+    REQUIRE_THROWS_AS(lstl::sort(v, key), std::runtime_error);
+}
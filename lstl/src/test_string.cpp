@@ -0,0 +1,94 @@
+#include "catch2/catch_test_macros.hpp"
+#include "lstl/String.hpp"
+#include <unordered_map>
+
+TEST_CASE("small and heap modes", "[string]") {
+    lstl::String s;
+    REQUIRE(s.empty());
+    REQUIRE(s.is_small());
+    REQUIRE(*s.c_str() == '\0');
+
+    lstl::String key("user:12345");
+    REQUIRE(key.is_small());
+    REQUIRE(key.size() == 10);
+    REQUIRE(key == "user:12345");
+
+    lstl::String full(23, 'x');
+    REQUIRE(full.is_small());
+    REQUIRE(full.size() == 23);
+    REQUIRE(full.c_str()[23] == '\0');
+    full.push_back('y');
+    REQUIRE_FALSE(full.is_small());
+    REQUIRE(full.size() == 24);
+    REQUIRE(full.back() == 'y');
+    REQUIRE(full.capacity() >= 46);
+
+    lstl::String copy(full);
+    lstl::String moved(std::move(full));
+    REQUIRE(copy == moved);
+    REQUIRE(full.empty());
+    copy = key;
+    REQUIRE(copy == key);
+    copy.swap(moved);
+    REQUIRE(moved == key);
+    REQUIRE(copy.size() == 24);
+}
+
+TEST_CASE("append and resize", "[string]") {
+    lstl::String s("ab");
+    for (int i = 0; i < 10; i++)
+        s.append(s);
+    REQUIRE(s.size() == 2048);
+    REQUIRE(s.substr(2046) == "ab");
+
+    s += 'c';
+    s += "de";
+    REQUIRE(s.ends_with("abcde"));
+    s.resize(3);
+    REQUIRE(s == "aba");
+    s.resize(5, '!');
+    REQUIRE(s == "aba!!");
+
+    lstl::String number;
+    number.resize_and_overwrite(16, [](char* p, std::size_t) {
+        std::memcpy(p, "12345", 5);
+        return 5;
+    });
+    REQUIRE(number == "12345");
+    REQUIRE(number.is_small());
+}
+
+TEST_CASE("find, compare and hash", "[string]") {
+    lstl::String s("the quick brown fox jumps over the lazy dog");
+    REQUIRE(s.find('q') == 4);
+    REQUIRE(s.find("the", 1) == 31);
+    REQUIRE(s.find("cat") == lstl::String::npos);
+    REQUIRE(s.find("") == 0);
+    REQUIRE(s.contains("fox"));
+    REQUIRE(s.starts_with("the"));
+
+    REQUIRE(lstl::String("abc") < lstl::StringView("abd"));
+    REQUIRE(lstl::String("ab") < lstl::String("abc"));
+    REQUIRE(lstl::StringView("b") > lstl::String("abc"));
+
+    constexpr auto h = lstl::StringView("user:12345").hash();
+    REQUIRE(lstl::String("user:12345").hash() == h);
+    REQUIRE(lstl::StringView("user:12346").hash() != h);
+
+    std::unordered_map<lstl::String, int, lstl::StringHash, std::equal_to<>>
+        map;
+    map.emplace("alpha", 1);
+    map.emplace(lstl::String(30, 'z'), 2);
+    REQUIRE(map.find(lstl::StringView("alpha"))->second == 1);
+    REQUIRE(map.count(lstl::String(30, 'z')) == 1);
+}
+
+TEST_CASE("self assignment", "[string]") {
+    lstl::String s("hello world, this is a long string");
+    s = s.substr(6);
+    REQUIRE(s == "world, this is a long string");
+    s = lstl::StringView(s).substr(7, 4);
+    REQUIRE(s == "this");
+    s = s;
+    REQUIRE(s == "this");
+}
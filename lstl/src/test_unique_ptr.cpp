@@ -0,0 +1,95 @@
+#include "catch2/catch_test_macros.hpp"
+#include "lstl/UniquePtr.hpp"
+#include "lstl/Vector.hpp"
+#include <memory>
+
+namespace {
+int g_alive = 0;
+struct Tracked {
+    int value;
+    explicit Tracked(int v = 0) : value(v) { g_alive++; }
+    ~Tracked() { g_alive--; }
+};
+
+struct CountingDeleter {
+    int* count;
+    void operator()(Tracked* p) {
+        ++*count;
+        delete p;
+    }
+};
+
+int g_allocs = 0;
+template <typename T> struct CountingAlloc {
+    using value_type = T;
+    CountingAlloc() = default;
+    template <typename U> CountingAlloc(CountingAlloc<U> const&) noexcept {}
+    T* allocate(std::size_t n) {
+        g_allocs++;
+        return std::allocator<T>().allocate(n);
+    }
+    void deallocate(T* p, std::size_t n) noexcept {
+        g_allocs--;
+        std::allocator<T>().deallocate(p, n);
+    }
+};
+} // namespace
+
+TEST_CASE("compressed storage", "[unique_ptr]") {
+    static_assert(sizeof(lstl::UniquePtr<int>) == sizeof(int*));
+    static_assert(sizeof(lstl::UniquePtr<int[]>) == sizeof(int*));
+    static_assert(sizeof(lstl::UniquePtr<Tracked, CountingDeleter>) ==
+                  2 * sizeof(void*));
+    static_assert(lstl::isTriviallyRelocatable<lstl::UniquePtr<Tracked>>);
+}
+
+TEST_CASE("stateful deleter", "[unique_ptr]") {
+    int deleted = 0;
+    {
+        lstl::UniquePtr<Tracked, CountingDeleter> p(new Tracked(1),
+                                                    CountingDeleter{&deleted});
+        p.reset(new Tracked(2));
+        REQUIRE(deleted == 1);
+        REQUIRE(p->value == 2);
+        auto q = std::move(p);
+        REQUIRE(!p);
+        REQUIRE(q.get_deleter().count == &deleted);
+    }
+    REQUIRE(deleted == 2);
+    REQUIRE(g_alive == 0);
+}
+
+TEST_CASE("array", "[unique_ptr]") {
+    {
+        auto p = lstl::makeUnique<Tracked[]>(4);
+        REQUIRE(g_alive == 4);
+        p[3].value = 5;
+        REQUIRE(p[3].value == 5);
+    }
+    REQUIRE(g_alive == 0);
+}
+
+TEST_CASE("allocateUnique", "[unique_ptr]") {
+    {
+        auto p = lstl::allocateUnique<Tracked>(CountingAlloc<char>(), 3);
+        static_assert(sizeof(p) == sizeof(void*));
+        REQUIRE(g_allocs == 1);
+        REQUIRE(p->value == 3);
+    }
+    REQUIRE(g_allocs == 0);
+    REQUIRE(g_alive == 0);
+}
+
+TEST_CASE("in vector", "[unique_ptr]") {
+    {
+        lstl::Vector<lstl::UniquePtr<Tracked>> v;
+        for (int i = 0; i < 1000; i++)
+            v.push_back(lstl::makeUnique<Tracked>(i));
+        REQUIRE(g_alive == 1000);
+        REQUIRE(v[999]->value == 999);
+        v.shrink_to_fit();
+        REQUIRE(v.capacity() == 1000);
+        REQUIRE(v[500]->value == 500);
+    }
+    REQUIRE(g_alive == 0);
+}